@@ -5,9 +5,11 @@
 #include <wayfire/workspace-set.hpp>
 #include <wayfire/view-helpers.hpp>
 #include <wayfire/core.hpp>
+#include <wayfire/output-layout.hpp>
 #include <wayfire/util.hpp>
 #include "animate.hpp"
 #include "plugins/common/wayfire/plugins/common/shared-core-data.hpp"
+#include "plugins/common/wayfire/plugins/common/animation-scheduler.hpp"
 #include "system_fade.hpp"
 #include "basic_animations.hpp"
 #include "squeezimize.hpp"
@@ -44,7 +46,7 @@ class animation_hook : public wf::custom_data_t
     }
 
     /* Update animation right before each frame */
-    wf::effect_hook_t update_animation_hook = [=] ()
+    wf::animation_step_t update_animation_hook = [=] ()
     {
         damage_whole_view();
         bool result = animation->step();
@@ -64,13 +66,12 @@ class animation_hook : public wf::custom_data_t
     {
         if (current_output)
         {
-            current_output->render->rem_effect(&update_animation_hook);
+            wf::animation_scheduler_t::remove(current_output, &update_animation_hook);
         }
 
         if (new_output)
         {
-            new_output->render->add_effect(&update_animation_hook,
-                wf::OUTPUT_EFFECT_PRE);
+            wf::animation_scheduler_t::get(new_output)->add(&update_animation_hook);
         }
 
         current_output = new_output;
@@ -245,6 +246,7 @@ class wayfire_animation : public wf::plugin_interface_t, private wf::per_output_
         output->connect(&on_view_pre_unmap);
         output->connect(&on_render_start);
         output->connect(&on_minimize_request);
+        wf::animation_scheduler_t::acquire(output);
         if (startup_duration.value().length_ms != 0)
         {
             output->render->add_inhibit(true);
@@ -264,6 +266,10 @@ class wayfire_animation : public wf::plugin_interface_t, private wf::per_output_
     void fini() override
     {
         cleanup_views_on_output(nullptr);
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            wf::animation_scheduler_t::release(wo);
+        }
 
         effects_registry->unregister_effect("fade");
         effects_registry->unregister_effect("zoom");
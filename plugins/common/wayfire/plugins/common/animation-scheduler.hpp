@@ -0,0 +1,167 @@
+#pragma once
+
+#include <wayfire/object.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/nonstd/observer_ptr.h>
+#include <wayfire/nonstd/safe-list.hpp>
+#include <functional>
+
+namespace wf
+{
+/**
+ * A single step of an animation, run once per frame by animation_scheduler_t.
+ *
+ * The step should advance the animation and damage what it changed through the scenegraph (for example with
+ * view->damage() or begin/end_transform_update()), so that nodes which cache their children's contents see
+ * the damage too. It may remove itself (or other steps) from the scheduler.
+ */
+using animation_step_t = std::function<void ()>;
+
+/**
+ * A per-output scheduler which drives all animations on the output from a single pre-render hook.
+ *
+ * Instead of each animation registering its own effect hook, animations add a step to the scheduler, and
+ * all steps are run in one pass on each frame. When no animation is active, the hook is removed, so the
+ * output stops repainting unless something else damages it.
+ *
+ * The scheduler is shared by all plugins on the output. Plugins using it hold a reference on each output
+ * with acquire(), and drop it with release() in their fini(). The scheduler is destroyed when the last
+ * plugin using it is unloaded, because its code lives in the plugin which created it.
+ */
+class animation_scheduler_t : public wf::custom_data_t
+{
+  public:
+    /**
+     * Get the scheduler of the given output, creating it if necessary.
+     */
+    static nonstd::observer_ptr<animation_scheduler_t> get(wf::output_t *output)
+    {
+        if (!output->has_data<animation_scheduler_t>())
+        {
+            output->store_data(std::make_unique<animation_scheduler_t>(output));
+        }
+
+        return output->get_data<animation_scheduler_t>();
+    }
+
+    /**
+     * Keep the scheduler of the given output alive until a matching release().
+     */
+    static void acquire(wf::output_t *output)
+    {
+        get(output)->use_count++;
+    }
+
+    /**
+     * Drop a reference taken with acquire(). The scheduler is destroyed with the last reference, so the
+     * caller must have removed its own steps before.
+     */
+    static void release(wf::output_t *output)
+    {
+        auto scheduler = output->get_data<animation_scheduler_t>();
+        if (scheduler && (--scheduler->use_count <= 0))
+        {
+            output->erase_data<animation_scheduler_t>();
+        }
+    }
+
+    /**
+     * Stop running the given step on the output, if the output has a scheduler.
+     * Unlike get(), this never creates a new scheduler.
+     */
+    static void remove(wf::output_t *output, animation_step_t *step)
+    {
+        if (auto scheduler = output->get_data<animation_scheduler_t>())
+        {
+            scheduler->remove(step);
+        }
+    }
+
+    animation_scheduler_t(wf::output_t *output)
+    {
+        this->output = output;
+        output->connect(&on_pre_remove);
+    }
+
+    ~animation_scheduler_t()
+    {
+        stop_hook();
+    }
+
+    animation_scheduler_t(const animation_scheduler_t&) = delete;
+    animation_scheduler_t(animation_scheduler_t&&) = delete;
+    animation_scheduler_t& operator =(const animation_scheduler_t&) = delete;
+    animation_scheduler_t& operator =(animation_scheduler_t&&) = delete;
+
+    /**
+     * Start running the given step on each frame, until it is removed.
+     * The step has to stay alive until it is removed.
+     */
+    void add(animation_step_t *step)
+    {
+        steps.push_back(step);
+        if (!hook_active && !output_removed)
+        {
+            output->render->add_effect(&pre_hook, wf::OUTPUT_EFFECT_PRE);
+            output->render->schedule_redraw();
+            hook_active = true;
+        }
+    }
+
+    /**
+     * Stop running the given step. Safe to call from inside a step.
+     */
+    void remove(animation_step_t *step)
+    {
+        steps.remove_all(step);
+    }
+
+    /**
+     * @return The number of animations currently running on the output.
+     */
+    size_t size() const
+    {
+        return steps.size();
+    }
+
+  private:
+    wf::output_t *output;
+    wf::safe_list_t<animation_step_t*> steps;
+    bool hook_active = false;
+    int use_count    = 0;
+    /* The scheduler is custom data on the output, so it outlives the output's render manager. */
+    bool output_removed = false;
+
+    void stop_hook()
+    {
+        if (hook_active)
+        {
+            output->render->rem_effect(&pre_hook);
+            hook_active = false;
+        }
+    }
+
+    wf::effect_hook_t pre_hook = [=] ()
+    {
+        steps.for_each([&] (animation_step_t *step)
+        {
+            (*step)();
+        });
+
+        if (steps.size() == 0)
+        {
+            // Nothing is animating anymore, let the output go idle.
+            stop_hook();
+        }
+    };
+
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_pre_remove =
+        [=] (wf::output_pre_remove_signal *ev)
+    {
+        stop_hook();
+        output_removed = true;
+    };
+};
+}
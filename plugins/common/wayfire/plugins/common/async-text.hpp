@@ -0,0 +1,350 @@
+#pragma once
+
+#include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/shared-core-data.hpp>
+#include <wayfire/signal-provider.hpp>
+#include <wayfire/util/log.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace wf
+{
+/**
+ * Emitted on a rasterized_text_t when its texture becomes ready.
+ */
+struct text_rasterized_signal
+{};
+
+/**
+ * A text rendered by text_rasterizer_t.
+ */
+struct rasterized_text_t : public wf::signal::provider_t
+{
+    /* Whether the texture has been rendered already */
+    bool ready = false;
+    owned_texture_t texture;
+    /* The size needed to render the whole text, see cairo_text_t::render_text() */
+    wf::dimensions_t required_size = {0, 0};
+};
+
+/**
+ * A service which lays out and draws text with Pango/cairo in a pool of worker threads, so that rendering
+ * many texts at once (for example the titles of all views in scale) does not block the compositor.
+ *
+ * Only the upload of the finished image to a texture happens on the main thread. Finished texts are kept in
+ * a cache keyed by the text and all rendering parameters, so that texts which are shown repeatedly are
+ * rendered only once.
+ *
+ * The rasterizer is meant to be used as shared data, see wf::shared_data::ref_ptr_t.
+ */
+class text_rasterizer_t
+{
+  public:
+    /**
+     * Get the texture for the given text. If the text is not in the cache, the returned object is not ready
+     * yet, and it will emit text_rasterized_signal once it is.
+     */
+    std::shared_ptr<rasterized_text_t> request(const std::string& text, const cairo_text_t::params& par)
+    {
+        auto key = make_key(text, par);
+        auto it  = cache.find(key);
+        if (it != cache.end())
+        {
+            lru.splice(lru.begin(), lru, it->second.lru_position);
+            return it->second.text;
+        }
+
+        auto result = std::make_shared<rasterized_text_t>();
+        lru.push_front(key);
+        cache[key] = cache_entry_t{result, lru.begin()};
+        evict();
+
+        ensure_started();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(job_t{text, par, result, {}, {0, 0}});
+        }
+
+        cond.notify_one();
+        return result;
+    }
+
+    text_rasterizer_t() = default;
+    text_rasterizer_t(const text_rasterizer_t&) = delete;
+    text_rasterizer_t& operator =(const text_rasterizer_t&) = delete;
+
+    ~text_rasterizer_t()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        cond.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        if (done_source)
+        {
+            wl_event_source_remove(done_source);
+        }
+
+        if (done_fd >= 0)
+        {
+            close(done_fd);
+        }
+    }
+
+  private:
+    using key_t = std::tuple<std::string, int, double, double, double, double, double, double, double, double,
+        float, int, int, bool, bool, bool>;
+
+    static key_t make_key(const std::string& text, const cairo_text_t::params& par)
+    {
+        return key_t{text, par.font_size,
+            par.bg_color.r, par.bg_color.g, par.bg_color.b, par.bg_color.a,
+            par.text_color.r, par.text_color.g, par.text_color.b, par.text_color.a,
+            par.output_scale, par.max_size.width, par.max_size.height,
+            par.bg_rect, par.rounded_rect, par.exact_size};
+    }
+
+    struct cache_entry_t
+    {
+        std::shared_ptr<rasterized_text_t> text;
+        std::list<key_t>::iterator lru_position;
+    };
+
+    struct job_t
+    {
+        std::string text;
+        cairo_text_t::params par;
+        std::weak_ptr<rasterized_text_t> result;
+        cairo_text_t rendered;
+        wf::dimensions_t required_size;
+    };
+
+    /* Texts which are not in use anymore are dropped when the cache grows beyond this size. */
+    static constexpr size_t MAX_CACHED_TEXTS = 128;
+    static constexpr unsigned MAX_WORKERS    = 4;
+
+    std::map<key_t, cache_entry_t> cache;
+    // Most recently used keys first
+    std::list<key_t> lru;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<job_t> pending;
+    std::deque<job_t> finished;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+    int done_fd = -1;
+    wl_event_source *done_source = NULL;
+
+    void evict()
+    {
+        auto it = lru.end();
+        while ((cache.size() > MAX_CACHED_TEXTS) && (it != lru.begin()))
+        {
+            --it;
+            auto entry = cache.find(*it);
+            if (entry->second.text.use_count() == 1)
+            {
+                cache.erase(entry);
+                it = lru.erase(it);
+            }
+        }
+    }
+
+    void ensure_started()
+    {
+        if (!workers.empty())
+        {
+            return;
+        }
+
+        done_fd     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        done_source = wl_event_loop_add_fd(wf::get_core().ev_loop, done_fd, WL_EVENT_READABLE,
+            [] (int, uint32_t, void *data)
+        {
+            ((text_rasterizer_t*)data)->dispatch_finished();
+            return 0;
+        }, this);
+
+        const unsigned nr_workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_WORKERS);
+        for (unsigned i = 0; i < nr_workers; i++)
+        {
+            workers.emplace_back([this] () { run_worker(); });
+        }
+    }
+
+    void run_worker()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cond.wait(lock, [&] { return stopping || !pending.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+
+            auto job = std::move(pending.front());
+            pending.pop_front();
+
+            lock.unlock();
+            // Pango uses a separate font map for each thread, so layouts can be created concurrently.
+            job.required_size = job.rendered.rasterize(job.text, job.par);
+            lock.lock();
+
+            finished.push_back(std::move(job));
+            uint64_t one = 1;
+            if (write(done_fd, &one, sizeof(one)) < 0)
+            {
+                LOGE("Failed to notify the main loop about rendered text!");
+            }
+        }
+    }
+
+    void dispatch_finished()
+    {
+        uint64_t count;
+        if (read(done_fd, &count, sizeof(count)) < 0)
+        {
+            return;
+        }
+
+        std::deque<job_t> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(done, finished);
+        }
+
+        for (auto& job : done)
+        {
+            auto result = job.result.lock();
+            if (!result)
+            {
+                // Evicted from the cache before it was finished.
+                continue;
+            }
+
+            job.rendered.upload();
+            result->texture = job.rendered.release_texture();
+            result->required_size = job.required_size;
+            result->ready = true;
+
+            text_rasterized_signal data;
+            result->emit(&data);
+        }
+    }
+};
+
+/**
+ * A text which is rendered asynchronously with the shared text_rasterizer_t.
+ *
+ * Until the new text is ready, the previous one (if any) is kept as a placeholder. While a text is being
+ * rendered, further updates are coalesced, so that at most one request is in flight.
+ */
+class async_cairo_text_t
+{
+  public:
+    /* Called when the texture changes after the text has been rendered in the background. */
+    std::function<void()> on_ready;
+
+    async_cairo_text_t()
+    {
+        on_rasterized.set_callback([=] (text_rasterized_signal*)
+        {
+            current = std::move(in_flight);
+            in_flight.reset();
+            on_rasterized.disconnect();
+
+            if (queued.has_value())
+            {
+                auto [text, par] = std::move(queued.value());
+                queued.reset();
+                set_text(text, par);
+            }
+
+            if (on_ready)
+            {
+                on_ready();
+            }
+        });
+    }
+
+    async_cairo_text_t(const async_cairo_text_t&) = delete;
+    async_cairo_text_t& operator =(const async_cairo_text_t&) = delete;
+
+    /**
+     * Request the text to be rendered with the given parameters. If the text is cached, it is used
+     * immediately, and on_ready is not called.
+     */
+    void set_text(const std::string& text, const cairo_text_t::params& par)
+    {
+        if (in_flight)
+        {
+            queued = {text, par};
+            return;
+        }
+
+        auto next = rasterizer->request(text, par);
+        if (next->ready)
+        {
+            current = std::move(next);
+            return;
+        }
+
+        in_flight = std::move(next);
+        in_flight->connect(&on_rasterized);
+    }
+
+    /**
+     * Whether a text is being rendered in the background.
+     */
+    bool is_pending() const
+    {
+        return in_flight != nullptr;
+    }
+
+    wf::texture_t get_texture() const
+    {
+        return current ? current->texture.get_texture() : wf::texture_t{};
+    }
+
+    wf::dimensions_t get_size() const
+    {
+        return current ? current->texture.get_size() : wf::dimensions_t{0, 0};
+    }
+
+    /**
+     * Get the size needed to render the whole text, see cairo_text_t::render_text().
+     */
+    wf::dimensions_t get_required_size() const
+    {
+        return current ? current->required_size : wf::dimensions_t{0, 0};
+    }
+
+  private:
+    wf::shared_data::ref_ptr_t<text_rasterizer_t> rasterizer;
+    std::shared_ptr<rasterized_text_t> current;
+    std::shared_ptr<rasterized_text_t> in_flight;
+    std::optional<std::pair<std::string, cairo_text_t::params>> queued;
+    wf::signal::connection_t<text_rasterized_signal> on_rasterized;
+};
+}
@@ -168,6 +168,19 @@ struct cairo_text_t
      *   that dimension.
      */
     wf::dimensions_t render_text(const std::string& text, const params& par)
+    {
+        auto ret = rasterize(text, par);
+        upload();
+        return ret;
+    }
+
+    /**
+     * Lay out and draw the text into the cairo surface, without uploading it to the texture.
+     * Unlike render_text(), this does not use the renderer, so it may be called from any thread.
+     *
+     * @return The same as render_text().
+     */
+    wf::dimensions_t rasterize(const std::string& text, const params& par)
     {
         if (!cr)
         {
@@ -264,10 +277,24 @@ struct cairo_text_t
         pango_cairo_show_layout(cr, layout);
         pango_font_description_free(font_desc);
         g_object_unref(layout);
+        return ret;
+    }
 
+    /**
+     * Upload the contents of the cairo surface, as drawn by rasterize(), to the texture.
+     */
+    void upload()
+    {
         cairo_surface_flush(surface);
         this->tex = owned_texture_t{surface};
-        return ret;
+    }
+
+    /**
+     * Take the texture out of this object, leaving it empty.
+     */
+    owned_texture_t release_texture()
+    {
+        return std::move(tex);
     }
 
     cairo_text_t() = default;
@@ -1,7 +1,7 @@
 #include "wayfire/output.hpp"
 #include "wayfire/scene.hpp"
 #include <wayfire/scene-render.hpp>
-#include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/async-text.hpp>
 
 class simple_text_node_t : public wf::scene::node_t
 {
@@ -12,16 +12,29 @@ class simple_text_node_t : public wf::scene::node_t
 
         void render(const wf::scene::render_instruction_t& data)
         {
+            if (!self->cr_text.get_texture().texture)
+            {
+                // Not rendered yet
+                return;
+            }
+
             auto g = self->get_bounding_box();
             data.pass->add_texture(self->cr_text.get_texture(), data.target, g, data.damage);
         }
     };
 
-    wf::cairo_text_t cr_text;
+    wf::async_cairo_text_t cr_text;
 
   public:
     simple_text_node_t() : node_t(false)
-    {}
+    {
+        cr_text.on_ready = [=] ()
+        {
+            wf::scene::damage_node(this->shared_from_this(), last_bbox);
+            last_bbox = get_bounding_box();
+            wf::scene::damage_node(this->shared_from_this(), last_bbox);
+        };
+    }
 
     void gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
         wf::scene::damage_callback push_damage, wf::output_t *output) override
@@ -49,15 +62,21 @@ class simple_text_node_t : public wf::scene::node_t
         this->params = params;
     }
 
+    /**
+     * Set the text to display. The text is rendered in the background, until it is ready, the previous text
+     * (if any) is displayed.
+     */
     void set_text(std::string text)
     {
         wf::scene::damage_node(this->shared_from_this(), get_bounding_box());
-        cr_text.render_text(text, params);
-        wf::scene::damage_node(this->shared_from_this(), get_bounding_box());
+        cr_text.set_text(text, params);
+        last_bbox = get_bounding_box();
+        wf::scene::damage_node(this->shared_from_this(), last_bbox);
     }
 
   private:
     wf::cairo_text_t::params params;
     std::optional<wf::dimensions_t> size;
     wf::point_t position;
+    wf::geometry_t last_bbox = {0, 0, 0, 0};
 };
@@ -11,6 +11,7 @@
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/output.hpp"
+#include "wayfire/util.hpp"
 
 namespace wf
 {
@@ -111,6 +112,19 @@ class workspace_wall_t : public wf::signal::provider_t
      */
     void set_ws_dim(const wf::point_t& ws, float value);
 
+    /**
+     * Set for how long the rendered workspace contents are kept after the
+     * output renderer is stopped.
+     *
+     * While the contents are kept, they are updated only from damage on the
+     * corresponding workspace, so that starting the output renderer again does
+     * not require repainting every workspace from scratch.
+     *
+     * @param timeout_ms The time in milliseconds, 0 means that the contents are
+     *   released as soon as the output renderer is stopped (the default).
+     */
+    void set_cache_timeout(int timeout_ms);
+
   protected:
     wf::output_t *output;
 
@@ -128,5 +142,10 @@ class workspace_wall_t : public wf::signal::provider_t
   protected:
     class workspace_wall_node_t;
     std::shared_ptr<workspace_wall_node_t> render_node;
+
+    class workspace_cache_t;
+    std::unique_ptr<workspace_cache_t> cache;
+    int cache_timeout = 0;
+    wf::wl_timer<false> release_cache_timer;
 };
 }
@@ -13,12 +13,142 @@ namespace wf
 {
 template<class Data> using per_workspace_map_t = std::map<int, std::map<int, Data>>;
 
+/**
+ * The cache keeps the last rendered contents of each workspace in an auxilliary buffer, together with the
+ * damage accumulated on that workspace since it was last rendered.
+ *
+ * It outlives the wall render node, so that restarting the output renderer (for example, opening Expo
+ * again) only needs to repaint the parts of the workspaces which actually changed in the meantime.
+ */
+class workspace_wall_t::workspace_cache_t
+{
+  public:
+    workspace_wall_t *wall;
+    wf::dimensions_t grid_size;
+    std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> workspaces;
+
+    // Render instances of each workspace, used to track damage even while the wall is not rendered.
+    per_workspace_map_t<std::vector<scene::render_instance_uptr>> instances;
+
+    // Buffers keeping the contents of almost-static workspaces. They are allocated the first time the
+    // workspace becomes visible.
+    per_workspace_map_t<wf::auxilliary_buffer_t> aux_buffers;
+    // Damage accumulated for those buffers
+    per_workspace_map_t<wf::region_t> aux_buffer_damage;
+    // Current rendering scale for the workspace
+    per_workspace_map_t<float> aux_buffer_current_scale;
+    // Current subbox for the workspace
+    per_workspace_map_t<std::optional<wf::geometry_t>> aux_buffer_current_subbox;
+
+    workspace_cache_t(workspace_wall_t *wall)
+    {
+        this->wall = wall;
+        this->grid_size = wall->output->wset()->get_workspace_grid_size();
+        workspaces.resize(grid_size.width);
+        for (int i = 0; i < grid_size.width; i++)
+        {
+            for (int j = 0; j < grid_size.height; j++)
+            {
+                auto node = std::make_shared<workspace_stream_node_t>(
+                    wall->output, wf::point_t{i, j});
+                workspaces[i].push_back(node);
+
+                aux_buffer_damage[i][j] |= node->get_bounding_box();
+                aux_buffer_current_scale[i][j]  = 1.0;
+                aux_buffer_current_subbox[i][j] = std::nullopt;
+            }
+        }
+
+        regen_instances();
+        wf::get_core().scene()->connect(&on_root_update);
+    }
+
+    bool is_valid_for_output() const
+    {
+        return grid_size == wall->output->wset()->get_workspace_grid_size();
+    }
+
+    /**
+     * Make sure the buffer for the given workspace is allocated with the current output size and scale.
+     */
+    void ensure_buffer(int i, int j)
+    {
+        auto bbox   = workspaces[i][j]->get_bounding_box();
+        auto result = aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale,
+            wf::buffer_allocation_hints_t{
+                .needs_alpha = false,
+            });
+
+        if (result == buffer_reallocation_result_t::REALLOCATED)
+        {
+            aux_buffer_damage[i][j] |= bbox;
+            aux_buffer_current_scale[i][j]  = 1.0;
+            aux_buffer_current_subbox[i][j] = std::nullopt;
+        }
+    }
+
+  private:
+    wf::signal::connection_t<scene::root_node_update_signal> on_root_update =
+        [=] (scene::root_node_update_signal *ev)
+    {
+        if (ev->flags & (scene::update_flag::CHILDREN_LIST | scene::update_flag::ENABLED))
+        {
+            regen_instances();
+        }
+    };
+
+    wf::geometry_t get_workspace_rect(wf::point_t ws)
+    {
+        auto output_size = wall->output->get_screen_size();
+        return {
+            .x     = ws.x * (output_size.width + wall->gap_size),
+            .y     = ws.y * (output_size.height + wall->gap_size),
+            .width = output_size.width,
+            .height = output_size.height,
+        };
+    }
+
+    void regen_instances()
+    {
+        for (int i = 0; i < grid_size.width; i++)
+        {
+            for (int j = 0; j < grid_size.height; j++)
+            {
+                auto push_damage_child = [=] (const wf::region_t& damage)
+                {
+                    // Store the damage because we'll have to update the buffers
+                    aux_buffer_damage[i][j] |= damage;
+                    if (!wall->render_node)
+                    {
+                        return;
+                    }
+
+                    wf::region_t our_damage;
+                    for (auto& rect : damage)
+                    {
+                        wf::geometry_t box = wlr_box_from_pixman_box(rect);
+                        box = box + wf::origin(get_workspace_rect({i, j}));
+                        auto A = wall->viewport;
+                        auto B = wall->render_node->get_bounding_box();
+                        our_damage |= scale_box(A, B, box);
+                    }
+
+                    // Also damage the 'screen' after transforming damage
+                    scene::damage_node(wall->render_node, our_damage);
+                };
+
+                instances[i][j].clear();
+                workspaces[i][j]->gen_render_instances(instances[i][j], push_damage_child, wall->output);
+            }
+        }
+    }
+};
+
 class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 {
     class wwall_render_instance_t : public scene::render_instance_t
     {
         std::shared_ptr<workspace_wall_node_t> self;
-        per_workspace_map_t<std::vector<scene::render_instance_uptr>> instances;
 
         scene::damage_callback push_damage;
         wf::signal::connection_t<scene::node_damage_signal> on_wall_damage =
@@ -38,6 +168,11 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             };
         }
 
+        workspace_cache_t& cache()
+        {
+            return *self->wall->cache;
+        }
+
       public:
         wwall_render_instance_t(workspace_wall_node_t *self,
             scene::damage_callback push_damage)
@@ -45,34 +180,6 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             this->self = std::dynamic_pointer_cast<workspace_wall_node_t>(self->shared_from_this());
             this->push_damage = push_damage;
             self->connect(&on_wall_damage);
-
-            for (int i = 0; i < (int)self->workspaces.size(); i++)
-            {
-                for (int j = 0; j < (int)self->workspaces[i].size(); j++)
-                {
-                    auto push_damage_child = [=] (const wf::region_t& damage)
-                    {
-                        // Store the damage because we'll have to update the buffers
-                        self->aux_buffer_damage[i][j] |= damage;
-
-                        wf::region_t our_damage;
-                        for (auto& rect : damage)
-                        {
-                            wf::geometry_t box = wlr_box_from_pixman_box(rect);
-                            box = box + wf::origin(get_workspace_rect({i, j}));
-                            auto A = self->wall->viewport;
-                            auto B = self->get_bounding_box();
-                            our_damage |= scale_box(A, B, box);
-                        }
-
-                        // Also damage the 'screen' after transforming damage
-                        push_damage(our_damage);
-                    };
-
-                    self->workspaces[i][j]->gen_render_instances(instances[i][j],
-                        push_damage_child, self->wall->output);
-                }
-            }
         }
 
         static int damage_sum_area(const wf::region_t& damage)
@@ -98,13 +205,13 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             //
             // Nonetheless, we need to make sure to rescale when this makes sense, and to avoid visual
             // artifacts.
-            auto bbox = self->workspaces[i][j]->get_bounding_box();
+            auto bbox = cache().workspaces[i][j]->get_bounding_box();
             float render_scale = std::max(
                 1.0 * bbox.width / self->wall->viewport.width,
                 1.0 * bbox.height / self->wall->viewport.height);
             render_scale = std::min(render_scale, 1.0f);
 
-            const float current_scale = self->aux_buffer_current_scale[i][j];
+            const float current_scale = cache().aux_buffer_current_scale[i][j];
 
             // Avoid keeping a low resolution if we are going up in the scale (for example, expo exit
             // animation) and we're close to the 1.0 scale. Otherwise, we risk popping artifacts as we
@@ -121,15 +228,15 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
             if ((repaint_cost_current_scale > repaint_rescale_cost) || rescale_magnification)
             {
-                self->aux_buffer_current_scale[i][j] = render_scale;
-                const auto full_size   = self->aux_buffers[i][j].get_size();
+                cache().aux_buffer_current_scale[i][j] = render_scale;
+                const auto full_size   = cache().aux_buffers[i][j].get_size();
                 const int scaled_width = std::clamp(std::ceil(render_scale * full_size.width),
                     1.0f, 1.0f * full_size.width);
                 const int scaled_height = std::clamp(std::ceil(render_scale * full_size.height),
                     1.0f, 1.0f * full_size.height);
 
-                self->aux_buffer_current_subbox[i][j] = wf::geometry_t{0, 0, scaled_width, scaled_height};
-                self->aux_buffer_damage[i][j] |= self->workspaces[i][j]->get_bounding_box();
+                cache().aux_buffer_current_subbox[i][j] = wf::geometry_t{0, 0, scaled_width, scaled_height};
+                cache().aux_buffer_damage[i][j] |= bbox;
                 return true;
             }
 
@@ -141,14 +248,21 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             const wf::render_target_t& target, wf::region_t& damage) override
         {
             // Update workspaces in a render pass
-            for (int i = 0; i < (int)self->workspaces.size(); i++)
+            for (int i = 0; i < (int)cache().workspaces.size(); i++)
             {
-                for (int j = 0; j < (int)self->workspaces[i].size(); j++)
+                for (int j = 0; j < (int)cache().workspaces[i].size(); j++)
                 {
                     const auto ws_bbox     = self->wall->get_workspace_rectangle({i, j});
                     const auto visible_box =
                         geometry_intersection(self->wall->viewport, ws_bbox) - wf::origin(ws_bbox);
-                    wf::region_t visible_damage = self->aux_buffer_damage[i][j] & visible_box;
+                    if ((visible_box.width <= 0) || (visible_box.height <= 0))
+                    {
+                        // Invisible workspaces keep accumulating damage until they become visible.
+                        continue;
+                    }
+
+                    cache().ensure_buffer(i, j);
+                    wf::region_t visible_damage = cache().aux_buffer_damage[i][j] & visible_box;
                     if (consider_rescale_workspace_buffer(i, j, visible_damage))
                     {
                         visible_damage |= visible_box;
@@ -156,20 +270,20 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
                     if (!visible_damage.empty())
                     {
-                        wf::render_target_t aux{self->aux_buffers[i][j]};
-                        aux.subbuffer = self->aux_buffer_current_subbox[i][j];
-                        aux.geometry  = self->workspaces[i][j]->get_bounding_box();
+                        wf::render_target_t aux{cache().aux_buffers[i][j]};
+                        aux.subbuffer = cache().aux_buffer_current_subbox[i][j];
+                        aux.geometry  = cache().workspaces[i][j]->get_bounding_box();
                         aux.scale     = self->wall->output->handle->scale;
 
                         render_pass_params_t params;
-                        params.instances = &instances[i][j];
+                        params.instances = &cache().instances[i][j];
                         params.damage    = visible_damage;
                         params.reference_output = self->wall->output;
                         params.target = aux;
                         params.flags  = RPASS_EMIT_SIGNALS;
                         wf::render_pass_t::run(params);
 
-                        self->aux_buffer_damage[i][j] ^= visible_damage;
+                        cache().aux_buffer_damage[i][j] ^= visible_damage;
                     }
                 }
             }
@@ -189,18 +303,24 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             data.pass->clear(data.damage, self->wall->background_color);
 
             auto damage = data.target.framebuffer_region_from_geometry_region(data.damage);
-            for (int i = 0; i < (int)self->workspaces.size(); i++)
+            for (int i = 0; i < (int)cache().workspaces.size(); i++)
             {
-                for (int j = 0; j < (int)self->workspaces[i].size(); j++)
+                for (int j = 0; j < (int)cache().workspaces[i].size(); j++)
                 {
+                    auto& buffer = cache().aux_buffers[i][j];
+                    if (!buffer.get_buffer())
+                    {
+                        // Not visible yet, see schedule_instructions()
+                        continue;
+                    }
+
                     auto box = wf::geometry_to_fbox(get_workspace_rect({i, j}));
                     auto A   = wf::geometry_to_fbox(self->wall->viewport);
                     auto B   = wf::geometry_to_fbox(self->get_bounding_box());
                     auto render_geometry = wf::scale_fbox(A, B, box);
-                    auto& buffer = self->aux_buffers[i][j];
 
                     float dim = self->wall->get_color_for_workspace({i, j});
-                    const auto& subbox = self->aux_buffer_current_subbox[i][j];
+                    const auto& subbox = cache().aux_buffer_current_subbox[i][j];
 
                     auto tex = wf::texture_t{buffer.get_texture()};
                     tex.filter_mode = WLR_SCALE_FILTER_BILINEAR;
@@ -224,12 +344,12 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
         void compute_visibility(wf::output_t *output, wf::region_t& visible) override
         {
-            for (int i = 0; i < (int)self->workspaces.size(); i++)
+            for (int i = 0; i < (int)cache().workspaces.size(); i++)
             {
-                for (int j = 0; j < (int)self->workspaces[i].size(); j++)
+                for (int j = 0; j < (int)cache().workspaces[i].size(); j++)
                 {
-                    wf::region_t ws_region = self->workspaces[i][j]->get_bounding_box();
-                    for (auto& ch : this->instances[i][j])
+                    wf::region_t ws_region = cache().workspaces[i][j]->get_bounding_box();
+                    for (auto& ch : cache().instances[i][j])
                     {
                         ch->compute_visibility(output, ws_region);
                     }
@@ -239,32 +359,9 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
     };
 
   public:
-    std::map<std::pair<int, int>, float> render_colors;
-
     workspace_wall_node_t(workspace_wall_t *wall) : node_t(false)
     {
-        this->wall  = wall;
-        auto [w, h] = wall->output->wset()->get_workspace_grid_size();
-        workspaces.resize(w);
-        for (int i = 0; i < w; i++)
-        {
-            for (int j = 0; j < h; j++)
-            {
-                auto node = std::make_shared<workspace_stream_node_t>(
-                    wall->output, wf::point_t{i, j});
-                workspaces[i].push_back(node);
-
-                auto bbox = workspaces[i][j]->get_bounding_box();
-
-                aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale,
-                    wf::buffer_allocation_hints_t{
-                        .needs_alpha = false,
-                    });
-                aux_buffer_damage[i][j] |= bbox;
-                aux_buffer_current_scale[i][j]  = 1.0;
-                aux_buffer_current_subbox[i][j] = std::nullopt;
-            }
-        }
+        this->wall = wall;
     }
 
     virtual void gen_render_instances(
@@ -292,16 +389,6 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
   private:
     workspace_wall_t *wall;
-    std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> workspaces;
-
-    // Buffers keeping the contents of almost-static workspaces
-    per_workspace_map_t<wf::auxilliary_buffer_t> aux_buffers;
-    // Damage accumulated for those buffers
-    per_workspace_map_t<wf::region_t> aux_buffer_damage;
-    // Current rendering scale for the workspace
-    per_workspace_map_t<float> aux_buffer_current_scale;
-    // Current subbox for the workspace
-    per_workspace_map_t<std::optional<wf::geometry_t>> aux_buffer_current_subbox;
 };
 
 workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
@@ -312,6 +399,8 @@ workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
 workspace_wall_t::~workspace_wall_t()
 {
     stop_output_renderer(false);
+    release_cache_timer.disconnect();
+    cache.reset();
 }
 
 void workspace_wall_t::set_background_color(const wf::color_t& color)
@@ -349,6 +438,12 @@ void workspace_wall_t::render_wall(
 void workspace_wall_t::start_output_renderer()
 {
     wf::dassert(render_node == nullptr, "Starting workspace-wall twice?");
+    release_cache_timer.disconnect();
+    if (!cache || !cache->is_valid_for_output())
+    {
+        cache = std::make_unique<workspace_cache_t>(this);
+    }
+
     render_node = std::make_shared<workspace_wall_node_t>(this);
     scene::add_front(wf::get_core().scene(), render_node);
 }
@@ -363,6 +458,14 @@ void workspace_wall_t::stop_output_renderer(bool reset_viewport)
     scene::remove_child(render_node);
     render_node = nullptr;
 
+    if (cache_timeout > 0)
+    {
+        release_cache_timer.set_timeout(cache_timeout, [=] () { cache.reset(); });
+    } else
+    {
+        cache.reset();
+    }
+
     if (reset_viewport)
     {
         set_viewport({0, 0, 0, 0});
@@ -397,6 +500,11 @@ void workspace_wall_t::set_ws_dim(const wf::point_t& ws, float value)
     }
 }
 
+void workspace_wall_t::set_cache_timeout(int timeout_ms)
+{
+    this->cache_timeout = timeout_ms;
+}
+
 float workspace_wall_t::get_color_for_workspace(wf::point_t ws)
 {
     auto it = render_colors.find({ws.x, ws.y});
@@ -0,0 +1,149 @@
+#ifndef WF_CUBE_VISIBILITY_HPP
+#define WF_CUBE_VISIBILITY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/* The geometry of the cube faces, kept free of any rendering state so that it can be tested. */
+namespace wf
+{
+namespace cube
+{
+/**
+ * Calculate the base model matrix for the i-th side of the cube.
+ *
+ * @param side_angle The angle between two neighbouring faces.
+ * @param rotation The current rotation of the cube around the y axis.
+ * @param z_offset The distance of each face from the center of the cube.
+ */
+inline glm::mat4 face_model_matrix(int i, int num_faces, float side_angle, float rotation, float z_offset)
+{
+    const float angle = i * side_angle + rotation;
+    auto rotation_matrix = glm::rotate(glm::mat4(1.0), angle, glm::vec3(0, 1, 0));
+
+    double additional_z = 0.0;
+    // Special case: 2 faces
+    // In this case, we need to make sure that the two faces are just
+    // slightly moved away from each other, to avoid artifacts which can
+    // happen if both sides are touching.
+    if (num_faces == 2)
+    {
+        additional_z = 1e-3;
+    }
+
+    auto translation = glm::translate(glm::mat4(1.0),
+        glm::vec3(0, 0, z_offset + additional_z));
+
+    return rotation_matrix * translation;
+}
+
+/**
+ * Find out which faces of the cube can be seen with the given rotation and camera.
+ *
+ * A face is hidden if it is facing away from the camera and it is fully covered by the faces which
+ * are facing the camera. Faces facing away can still be seen through the open top and bottom of the
+ * cube, or when the camera is inside the cube, so we check the coverage explicitly.
+ *
+ * @param view The view matrix, including the zoom scaling.
+ * @param projection The projection matrix.
+ *
+ * @return For each face (in the order used by face_model_matrix()), whether it is visible.
+ */
+inline std::vector<bool> compute_visible_faces(int num_faces, float side_angle, float rotation,
+    float z_offset, const glm::mat4& view, const glm::mat4& projection)
+{
+    std::vector<bool> visible(num_faces, true);
+
+    static const glm::vec4 corners[] = {
+        {-0.5, 0.5, 0, 1}, {0.5, 0.5, 0, 1}, {0.5, -0.5, 0, 1}, {-0.5, -0.5, 0, 1},
+    };
+
+    struct projected_face_t
+    {
+        bool front;
+        glm::vec2 corners[4];
+    };
+
+    std::vector<projected_face_t> faces(num_faces);
+    for (int i = 0; i < num_faces; i++)
+    {
+        auto mv = view * face_model_matrix(i, num_faces, side_angle, rotation, z_offset);
+        glm::vec3 center = mv * glm::vec4{0, 0, 0, 1};
+        glm::vec3 normal = mv * glm::vec4{0, 0, 1, 0};
+        faces[i].front = glm::dot(normal, -center) > 0;
+
+        for (int j = 0; j < 4; j++)
+        {
+            auto clip = projection * mv * corners[j];
+            if (clip.w <= 1e-6)
+            {
+                // Part of the face is behind the camera, we cannot reason about coverage.
+                return visible;
+            }
+
+            faces[i].corners[j] = glm::vec2{clip} / clip.w;
+        }
+    }
+
+    const auto& inside_face = [] (const projected_face_t& face, glm::vec2 point)
+    {
+        const float eps = 1e-4;
+        int sign = 0;
+        for (int j = 0; j < 4; j++)
+        {
+            glm::vec2 a = face.corners[j];
+            glm::vec2 b = face.corners[(j + 1) % 4];
+            float cross = (b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x);
+            if (std::abs(cross) <= eps)
+            {
+                continue;
+            }
+
+            int s = (cross > 0) ? 1 : -1;
+            if (sign && (s != sign))
+            {
+                return false;
+            }
+
+            sign = s;
+        }
+
+        return true;
+    };
+
+    for (int i = 0; i < num_faces; i++)
+    {
+        if (faces[i].front)
+        {
+            continue;
+        }
+
+        // Check the corners, edge midpoints and the center of the face.
+        std::vector<glm::vec2> samples;
+        glm::vec2 center = {0, 0};
+        for (int j = 0; j < 4; j++)
+        {
+            samples.push_back(faces[i].corners[j]);
+            samples.push_back((faces[i].corners[j] + faces[i].corners[(j + 1) % 4]) * 0.5f);
+            center += faces[i].corners[j] * 0.25f;
+        }
+
+        samples.push_back(center);
+        visible[i] = !std::all_of(samples.begin(), samples.end(), [&] (glm::vec2 point)
+        {
+            return std::any_of(faces.begin(), faces.end(), [&] (const projected_face_t& face)
+            {
+                return face.front && inside_face(face, point);
+            });
+        });
+    }
+
+    return visible;
+}
+}
+}
+
+#endif /* end of include guard: WF_CUBE_VISIBILITY_HPP */
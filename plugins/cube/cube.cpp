@@ -1,5 +1,6 @@
 #include <wayfire/per-output-plugin.hpp>
 #include <memory>
+#include <algorithm>
 #include <wayfire/plugin.hpp>
 #include <wayfire/opengl.hpp>
 #include <wayfire/output.hpp>
@@ -15,6 +16,7 @@
 #include <wayfire/img.hpp>
 
 #include "cube.hpp"
+#include "cube-visibility.hpp"
 #include "simple-background.hpp"
 #include "skydome.hpp"
 #include "cubemap.hpp"
@@ -47,8 +49,9 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
             wf::scene::damage_callback push_damage;
 
             std::vector<std::vector<wf::scene::render_instance_uptr>> ws_instances;
-            std::vector<wf::region_t> ws_damage;
-            std::vector<wf::auxilliary_buffer_t> framebuffers;
+            // The faces which were found visible when scheduling the current frame. The animation advances
+            // with time, so they are not recomputed when rendering.
+            std::vector<bool> visible_faces;
 
             wf::signal::connection_t<wf::scene::node_damage_signal> on_cube_damage =
                 [=] (wf::scene::node_damage_signal *ev)
@@ -63,21 +66,17 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
                 this->push_damage = push_damage;
                 self->connect(&on_cube_damage);
 
-                ws_damage.resize(self->workspaces.size());
-                framebuffers.resize(self->workspaces.size());
                 ws_instances.resize(self->workspaces.size());
                 for (int i = 0; i < (int)self->workspaces.size(); i++)
                 {
                     auto push_damage_child = [=] (const wf::region_t& damage)
                     {
-                        ws_damage[i] |= damage;
+                        self->ws_damage[i] |= damage;
                         push_damage(self->get_bounding_box());
                     };
 
                     self->workspaces[i]->gen_render_instances(ws_instances[i],
                         push_damage_child, self->cube->output);
-
-                    ws_damage[i] |= self->workspaces[i]->get_bounding_box();
                 }
             }
 
@@ -98,31 +97,50 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
 
                 damage ^= bbox;
 
+                auto cws = self->cube->output->wset()->get_current_workspace();
+                visible_faces = self->cube->compute_visible_faces();
                 for (int i = 0; i < (int)ws_instances.size(); i++)
                 {
+                    // Faces which are hidden behind other faces keep accumulating damage until they become
+                    // visible again.
+                    const int face = (i - cws.x + (int)ws_instances.size()) % (int)ws_instances.size();
+                    if (!visible_faces[face])
+                    {
+                        continue;
+                    }
+
                     const float scale = self->cube->output->handle->scale;
                     auto bbox = self->workspaces[i]->get_bounding_box();
-                    framebuffers[i].allocate(wf::dimensions(bbox), scale);
+                    if (self->framebuffers[i].allocate(wf::dimensions(bbox), scale) !=
+                        wf::buffer_reallocation_result_t::SAME)
+                    {
+                        self->ws_damage[i] |= bbox;
+                    }
 
-                    wf::render_target_t target{framebuffers[i]};
+                    if (self->ws_damage[i].empty())
+                    {
+                        continue;
+                    }
+
+                    wf::render_target_t target{self->framebuffers[i]};
                     target.geometry = self->workspaces[i]->get_bounding_box();
                     target.scale    = self->cube->output->handle->scale;
 
                     wf::render_pass_params_t params;
                     params.instances = &ws_instances[i];
-                    params.damage    = ws_damage[i];
+                    params.damage    = self->ws_damage[i];
                     params.reference_output = self->cube->output;
                     params.target = target;
                     params.flags  = wf::RPASS_CLEAR_BACKGROUND | wf::RPASS_EMIT_SIGNALS;
 
                     wf::render_pass_t::run(params);
-                    ws_damage[i].clear();
+                    self->ws_damage[i].clear();
                 }
             }
 
             void render(const wf::scene::render_instruction_t& data) override
             {
-                self->cube->render(data, framebuffers);
+                self->cube->render(data, self->framebuffers, visible_faces);
             }
 
             void compute_visibility(wf::output_t *output, wf::region_t& visible) override
@@ -149,6 +167,10 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
                 auto node = std::make_shared<wf::workspace_stream_node_t>(cube->output, wf::point_t{i, y});
                 workspaces.push_back(node);
             }
+
+            // The face buffers live on the node, so that they survive regenerating the render instances.
+            framebuffers.resize(w);
+            ws_damage.resize(w);
         }
 
         virtual void gen_render_instances(
@@ -171,6 +193,9 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
 
       private:
         std::vector<std::shared_ptr<wf::workspace_stream_node_t>> workspaces;
+        // The contents of each face and the damage accumulated since they were last updated.
+        std::vector<wf::auxilliary_buffer_t> framebuffers;
+        std::vector<wf::region_t> ws_damage;
         wayfire_cube *cube;
     };
 
@@ -562,28 +587,35 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
     /* Calculate the base model matrix for the i-th side of the cube */
     glm::mat4 calculate_model_matrix(int i)
     {
-        const float angle =
-            i * animation.side_angle + animation.cube_animation.rotation;
-        auto rotation = glm::rotate(glm::mat4(1.0), angle, glm::vec3(0, 1, 0));
+        return wf::cube::face_model_matrix(i, get_num_faces(), animation.side_angle,
+            animation.cube_animation.rotation, identity_z_offset);
+    }
 
-        double additional_z = 0.0;
-        // Special case: 2 faces
-        // In this case, we need to make sure that the two faces are just
-        // slightly moved away from each other, to avoid artifacts which can
-        // happen if both sides are touching.
-        if (get_num_faces() == 2)
+    /**
+     * Find out which faces of the cube can be seen with the current rotation and zoom.
+     *
+     * @return For each face (in the order used by calculate_model_matrix()), whether it is visible.
+     */
+    std::vector<bool> compute_visible_faces()
+    {
+        if (tessellation_support && (use_deform != 0) && (animation.cube_animation.ease_deformation > 0))
         {
-            additional_z = 1e-3;
+            // The faces are not flat anymore, be conservative.
+            return std::vector<bool>(get_num_faces(), true);
         }
 
-        auto translation = glm::translate(glm::mat4(1.0),
-            glm::vec3(0, 0, identity_z_offset + additional_z));
+        float zoom_factor = animation.cube_animation.zoom;
+        auto scale_matrix = glm::scale(glm::mat4(1.0),
+            glm::vec3(1. / zoom_factor, 1. / zoom_factor, 1. / zoom_factor));
 
-        return rotation * translation;
+        return wf::cube::compute_visible_faces(get_num_faces(), animation.side_angle,
+            animation.cube_animation.rotation, identity_z_offset,
+            animation.view * scale_matrix, animation.projection);
     }
 
     /* Render the sides of the cube, using the given culling mode - cw or ccw */
-    void render_cube(GLuint front_face, std::vector<wf::auxilliary_buffer_t>& buffers)
+    void render_cube(GLuint front_face, std::vector<wf::auxilliary_buffer_t>& buffers,
+        const std::vector<bool>& visible_faces)
     {
         GL_CALL(glFrontFace(front_face));
         static const GLuint indexData[] = {0, 1, 2, 0, 2, 3};
@@ -591,7 +623,18 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
         auto cws = output->wset()->get_current_workspace();
         for (int i = 0; i < get_num_faces(); i++)
         {
+            if (!visible_faces[i])
+            {
+                continue;
+            }
+
             int index = (cws.x + i) % get_num_faces();
+            if (!buffers[index].get_buffer())
+            {
+                // The face was never updated, for example because its buffer could not be allocated.
+                continue;
+            }
+
             GL_CALL(glBindTexture(GL_TEXTURE_2D, wf::gles_texture_t::from_aux(buffers[index]).tex_id));
 
             auto model = calculate_model_matrix(i);
@@ -610,7 +653,8 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
         }
     }
 
-    void render(const wf::scene::render_instruction_t& data, std::vector<wf::auxilliary_buffer_t>& buffers)
+    void render(const wf::scene::render_instruction_t& data, std::vector<wf::auxilliary_buffer_t>& buffers,
+        const std::vector<bool>& visible_faces)
     {
         data.pass->custom_gles_subpass([&]
         {
@@ -658,8 +702,8 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
              * that are on the back, and then we render those at the front, so we
              * don't have to use depth testing and we also can support alpha cube. */
             GL_CALL(glEnable(GL_CULL_FACE));
-            render_cube(GL_CCW, buffers);
-            render_cube(GL_CW, buffers);
+            render_cube(GL_CCW, buffers, visible_faces);
+            render_cube(GL_CW, buffers, visible_faces);
             GL_CALL(glDisable(GL_CULL_FACE));
 
             GL_CALL(glDisable(GL_DEPTH_TEST));
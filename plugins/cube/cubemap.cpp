@@ -7,6 +7,32 @@
 
 #include "cubemap-shaders.tpp"
 
+static const GLfloat cube_vertices[] = {
+    -1.0, 1.0, 1.0,
+    -1.0, -1.0, 1.0,
+    1.0, -1.0, 1.0,
+    1.0, 1.0, 1.0,
+    -1.0, 1.0, -1.0,
+    -1.0, -1.0, -1.0,
+    1.0, -1.0, -1.0,
+    1.0, 1.0, -1.0,
+};
+
+static const GLushort cube_indices[] = {
+    3, 7, 6, // right
+    3, 6, 2, // right
+    4, 0, 1, // left
+    4, 1, 5, // left
+    4, 7, 3, // top
+    4, 3, 0, // top
+    1, 2, 6, // bottom
+    1, 6, 5, // bottom
+    0, 3, 2, // front
+    0, 2, 1, // front
+    7, 4, 5, // back
+    7, 5, 6, // back
+};
+
 wf_cube_background_cubemap::wf_cube_background_cubemap()
 {
     create_program();
@@ -49,6 +75,16 @@ void wf_cube_background_cubemap::reload_texture()
             GL_CALL(glGenTextures(1, &tex));
             GL_CALL(glGenBuffers(1, &vbo_cube_vertices));
             GL_CALL(glGenBuffers(1, &ibo_cube_indices));
+
+            // The cube geometry never changes, so upload it only once.
+            GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_cube_vertices));
+            GL_CALL(glBufferData(GL_ARRAY_BUFFER, sizeof(cube_vertices), cube_vertices,
+                GL_STATIC_DRAW));
+            GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_cube_indices));
+            GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cube_indices), cube_indices,
+                GL_STATIC_DRAW));
+            GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+            GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
         }
 
         GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
@@ -98,38 +134,8 @@ void wf_cube_background_cubemap::render_frame(const wf::render_target_t& fb,
 
     GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
 
-    GLfloat cube_vertices[] = {
-        -1.0, 1.0, 1.0,
-        -1.0, -1.0, 1.0,
-        1.0, -1.0, 1.0,
-        1.0, 1.0, 1.0,
-        -1.0, 1.0, -1.0,
-        -1.0, -1.0, -1.0,
-        1.0, -1.0, -1.0,
-        1.0, 1.0, -1.0,
-    };
-
-    GLushort cube_indices[] = {
-        3, 7, 6, // right
-        3, 6, 2, // right
-        4, 0, 1, // left
-        4, 1, 5, // left
-        4, 7, 3, // top
-        4, 3, 0, // top
-        1, 2, 6, // bottom
-        1, 6, 5, // bottom
-        0, 3, 2, // front
-        0, 2, 1, // front
-        7, 4, 5, // back
-        7, 5, 6, // back
-    };
-
     glBindBuffer(GL_ARRAY_BUFFER, vbo_cube_vertices);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cube_vertices), cube_vertices,
-        GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_cube_indices);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cube_indices), cube_indices,
-        GL_STATIC_DRAW);
 
     GLint vertex = glGetAttribLocation(program.get_program_id(
         wf::TEXTURE_TYPE_RGBA), "position");
@@ -28,6 +28,13 @@ wf_cube_background_skydome::~wf_cube_background_skydome()
         {
             GL_CALL(glDeleteTextures(1, &tex));
         }
+
+        if (vbo_vertices)
+        {
+            GL_CALL(glDeleteBuffers(1, &vbo_vertices));
+            GL_CALL(glDeleteBuffers(1, &vbo_coords));
+            GL_CALL(glDeleteBuffers(1, &ibo_indices));
+        }
     });
 }
 
@@ -124,6 +131,30 @@ void wf_cube_background_skydome::fill_vertices()
             indices.push_back((i - 1) * gw + j + gw + 1);
         }
     }
+
+    upload_vertices();
+}
+
+void wf_cube_background_skydome::upload_vertices()
+{
+    if (!vbo_vertices)
+    {
+        GL_CALL(glGenBuffers(1, &vbo_vertices));
+        GL_CALL(glGenBuffers(1, &vbo_coords));
+        GL_CALL(glGenBuffers(1, &ibo_indices));
+    }
+
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices));
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat),
+        vertices.data(), GL_STATIC_DRAW));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_coords));
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, coords.size() * sizeof(GLfloat),
+        coords.data(), GL_STATIC_DRAW));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_indices));
+    GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+        indices.data(), GL_STATIC_DRAW));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
 
 void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
@@ -154,8 +185,11 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
     auto vp = wf::gles::output_transform(fb) * attribs.projection * view * rotation;
     program.uniformMatrix4f("VP", vp);
 
-    program.attrib_pointer("position", 3, 0, vertices.data());
-    program.attrib_pointer("uvPosition", 2, 0, coords.data());
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices));
+    program.attrib_pointer("position", 3, 0, nullptr);
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_coords));
+    program.attrib_pointer("uvPosition", 2, 0, nullptr);
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
     auto cws   = output->wset()->get_current_workspace();
     auto model = glm::rotate(glm::mat4(1.0),
@@ -167,9 +201,11 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
     GL_CALL(glActiveTexture(GL_TEXTURE0));
     GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
 
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_indices));
     GL_CALL(glDrawElements(GL_TRIANGLES,
         6 * SKYDOME_GRID_WIDTH * (SKYDOME_GRID_HEIGHT - 2),
-        GL_UNSIGNED_INT, indices.data()));
+        GL_UNSIGNED_INT, nullptr));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
     program.deactivate();
 }
@@ -28,6 +28,12 @@ class wf_cube_background_skydome : public wf_cube_background_base
     std::vector<GLfloat> coords;
     std::vector<GLuint> indices;
 
+    /* The grid is uploaded to the GPU once, whenever it is regenerated. */
+    GLuint vbo_vertices = 0;
+    GLuint vbo_coords   = 0;
+    GLuint ibo_indices  = 0;
+    void upload_vertices();
+
     std::string last_background_image;
     int last_mirror = -1;
     wf::option_wrapper_t<std::string> background_image{"cube/skydome_texture"};
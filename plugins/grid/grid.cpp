@@ -5,7 +5,9 @@
 #include <wayfire/workarea.hpp>
 #include <wayfire/workspace-set.hpp>
 #include <wayfire/render-manager.hpp>
+#include <wayfire/output-layout.hpp>
 #include <cmath>
+#include <typeinfo>
 #include <linux/input-event-codes.h>
 #include "wayfire/plugin.hpp"
 #include "wayfire/signal-definitions.hpp"
@@ -172,6 +174,7 @@ class wayfire_grid : public wf::plugin_interface_t, public wf::per_output_tracke
         output->connect(&on_maximize_signal);
         output->connect(&on_fullscreen_signal);
         output->connect(&on_tiled);
+        wf::animation_scheduler_t::acquire(output);
     }
 
     void handle_output_removed(wf::output_t *output) override
@@ -182,6 +185,20 @@ class wayfire_grid : public wf::plugin_interface_t, public wf::per_output_tracke
     void fini() override
     {
         fini_output_tracking();
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            // The tile plugin stores its own animations under the same key.
+            auto animation = view->get_data<wf::grid::grid_animation_t>();
+            if (animation && (typeid(*animation.get()) == typeid(wf::grid::grid_animation_t)))
+            {
+                view->erase_data<wf::grid::grid_animation_t>();
+            }
+        }
+
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            wf::animation_scheduler_t::release(wo);
+        }
     }
 
     bool can_adjust_view(wayfire_toplevel_view view)
@@ -14,6 +14,7 @@
 #include <wayfire/output.hpp>
 #include <wayfire/nonstd/wlroots.hpp>
 #include <wayfire/plugins/common/geometry-animation.hpp>
+#include <wayfire/plugins/common/animation-scheduler.hpp>
 #include <wayfire/render-manager.hpp>
 #include <wayfire/plugins/wobbly/wobbly-signal.hpp>
 #include <wayfire/toplevel.hpp>
@@ -195,7 +196,7 @@ class grid_animation_t : public wf::custom_data_t
         this->type   = type;
         this->animation = wf::geometry_animation_t{duration};
 
-        output->render->add_effect(&pre_hook, wf::OUTPUT_EFFECT_PRE);
+        wf::animation_scheduler_t::get(output)->add(&step);
         output->connect(&on_disappear);
     }
 
@@ -262,7 +263,7 @@ class grid_animation_t : public wf::custom_data_t
     ~grid_animation_t()
     {
         view->get_transformed_node()->rem_transformer<crossfade_node_t>();
-        output->render->rem_effect(&pre_hook);
+        wf::animation_scheduler_t::remove(output, &step);
     }
 
     grid_animation_t(const grid_animation_t &) = delete;
@@ -271,7 +272,7 @@ class grid_animation_t : public wf::custom_data_t
     grid_animation_t& operator =(grid_animation_t&&) = delete;
 
   protected:
-    wf::effect_hook_t pre_hook = [=] ()
+    wf::animation_step_t step = [=] ()
     {
         if (!animation.running())
         {
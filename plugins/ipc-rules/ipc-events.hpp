@@ -2,10 +2,12 @@
 
 #include "ipc-rules-common.hpp"
 #include <set>
+#include <optional>
 #include "wayfire/output-layout.hpp"
 #include "wayfire/plugins/ipc/ipc-method-repository.hpp"
 #include "wayfire/seat.hpp"
 #include <wayfire/per-output-plugin.hpp>
+#include <wayfire/render-manager.hpp>
 #include <wayfire/signal-definitions.hpp>
 #include "plugins/wm-actions/wm-actions-signals.hpp"
 
@@ -157,10 +159,59 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
         {"wset-workspace-changed", get_generic_output_registration_cb(&on_wset_workspace_changed)},
     };
 
+    /**
+     * Filters of a client subscription. Each filter applies only to events which carry the kind of object it
+     * is about: view-id and app-id filters to events about a view, and output-id filters to events about an
+     * output or a view on it. An empty filter matches everything.
+     */
+    struct event_filter_t
+    {
+        std::set<uint64_t> view_ids;
+        std::set<std::string> app_ids;
+        std::set<uint64_t> output_ids;
+
+        bool matches(wayfire_view view, wf::output_t *output) const
+        {
+            if (view)
+            {
+                if (!view_ids.empty() && !view_ids.count(view->get_id()))
+                {
+                    return false;
+                }
+
+                if (!app_ids.empty() && !app_ids.count(view->get_app_id()))
+                {
+                    return false;
+                }
+
+                output = output ?: view->get_output();
+            }
+
+            if (output && !output_ids.empty() && !output_ids.count(output->get_id()))
+            {
+                return false;
+            }
+
+            return true;
+        }
+    };
+
     struct client_watch_state_t
     {
         std::set<std::string> connected_events;
         bool connected_all = false;
+        event_filter_t filter;
+
+        /* Send at most one view-geometry-changed event per view and frame */
+        bool coalesce = false;
+        /* Views with a coalesced geometry change, with their geometry before the first change */
+        std::vector<std::pair<uint32_t, wf::geometry_t>> pending_geometry;
+
+        bool wants(const std::string& event_name, bool custom_event = false) const
+        {
+            return connected_events.empty() || connected_events.count(event_name) ||
+                   (custom_event && connected_all);
+        }
     };
 
     // Track a list of clients which have requested watch
@@ -181,6 +232,16 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
         }
 
         client_watch_state_t state;
+        if (data.has_member("filter"))
+        {
+            auto error = parse_filter(data["filter"], state.filter);
+            if (!error.empty())
+            {
+                return wf::ipc::json_error(error);
+            }
+        }
+
+        state.coalesce = wf::ipc::json_get_optional_bool(data, "coalesce").value_or(false);
         if (data.has_member(EVENTS))
         {
             for (size_t i = 0; i < data[EVENTS].size(); i++)
@@ -223,6 +284,72 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
         return wf::ipc::json_ok();
     };
 
+    /**
+     * Parse a filter of the form {"view-id": ..., "app-id": ..., "output-id": ...}, where each field is
+     * optional and is either a single value or a list of values.
+     *
+     * @return An error message, or an empty string on success.
+     */
+    static std::string parse_filter(const wf::json_t& json, event_filter_t& filter)
+    {
+        if (!json.is_object())
+        {
+            return "Filter is not an object!";
+        }
+
+        // Collect the values of a field, which can be a single value or an array of values
+        const auto& get_values = [&] (const std::string& field, std::vector<wf::json_t>& values)
+        {
+            if (!json.has_member(field))
+            {
+                return;
+            }
+
+            const wf::json_t& value = json[field];
+            if (!value.is_array())
+            {
+                values.push_back(value);
+                return;
+            }
+
+            for (size_t i = 0; i < value.size(); i++)
+            {
+                values.push_back(value[i]);
+            }
+        };
+
+        std::vector<wf::json_t> values;
+        for (auto field : {"view-id", "output-id"})
+        {
+            values.clear();
+            get_values(field, values);
+            for (auto& value : values)
+            {
+                if (!value.is_uint64())
+                {
+                    return "Filter field \"" + std::string(field) + "\" must contain ids!";
+                }
+
+                auto& ids = (field == std::string("view-id")) ? filter.view_ids : filter.output_ids;
+                ids.insert((uint64_t)value);
+            }
+        }
+
+        values.clear();
+        get_values("app-id", values);
+        for (auto& value : values)
+        {
+            if (!value.is_string())
+            {
+                return "Filter field \"app-id\" must contain strings!";
+            }
+
+            filter.app_ids.insert(value.as_string());
+        }
+
+        return "";
+    }
+
     wf::signal::connection_t<wf::ipc::client_disconnected_signal> on_client_disconnected =
         [=] (wf::ipc::client_disconnected_signal *ev)
     {
@@ -236,10 +363,13 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
 
     void send_view_to_subscribes(wayfire_view view, std::string event_name)
     {
-        wf::json_t event;
-        event["event"] = event_name;
-        event["view"]  = ipc_rules::view_to_json(view);
-        send_event_to_subscribes(event, event_name);
+        send_event_to_subscribes(event_name, view, nullptr, [&] ()
+        {
+            wf::json_t event;
+            event["event"] = event_name;
+            event["view"]  = ipc_rules::view_to_json(view);
+            return event;
+        });
     }
 
     void send_event_to_subscribes(const wf::json_t& data, const std::string& event_name,
@@ -247,14 +377,126 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     {
         for (auto& [client, state] : clients)
         {
-            if (state.connected_events.empty() || state.connected_events.count(event_name) ||
-                (custom_event && state.connected_all))
+            if (state.wants(event_name, custom_event))
             {
+                flush_pending_geometry(client, state);
                 client->send_json(data);
             }
         }
     }
 
+    /**
+     * Send an event about the given view and/or output to the clients which subscribed to it and whose
+     * filters match. The event is built with @build only if at least one client receives it.
+     */
+    template<class BuildEvent>
+    void send_event_to_subscribes(const std::string& event_name, wayfire_view view, wf::output_t *output,
+        BuildEvent build)
+    {
+        std::optional<wf::json_t> data;
+        for (auto& [client, state] : clients)
+        {
+            if (!state.wants(event_name) || !state.filter.matches(view, output))
+            {
+                continue;
+            }
+
+            if (!data)
+            {
+                data = build();
+            }
+
+            flush_pending_geometry(client, state);
+            client->send_json(*data);
+        }
+    }
+
+    static wf::json_t build_geometry_event(wayfire_view view, wf::geometry_t old_geometry)
+    {
+        wf::json_t data;
+        data["event"] = "view-geometry-changed";
+        data["old-geometry"] = wf::ipc::geometry_to_json(old_geometry);
+        data["view"] = ipc_rules::view_to_json(view);
+        return data;
+    }
+
+    /** Send the coalesced geometry changes of a client, so that they are not reordered with other events. */
+    void flush_pending_geometry(wf::ipc::client_interface_t *client, client_watch_state_t& state)
+    {
+        auto pending = std::move(state.pending_geometry);
+        state.pending_geometry.clear();
+        for (auto& [id, old_geometry] : pending)
+        {
+            if (auto view = wf::ipc::find_view_by_id(id))
+            {
+                client->send_json(build_geometry_event(view, old_geometry));
+            }
+        }
+    }
+
+    /* How long coalesced events may wait for a frame, e.g. when the view is not visible */
+    static constexpr int COALESCE_TIMEOUT_MS = 50;
+    wf::wl_timer<false> coalesce_timer;
+
+    void flush_all_pending_geometry()
+    {
+        on_frame_done.disconnect();
+        coalesce_timer.disconnect();
+
+        // Views are described once for all clients
+        std::map<uint32_t, std::optional<wf::json_t>> described;
+        for (auto& [client, state] : clients)
+        {
+            auto pending = std::move(state.pending_geometry);
+            state.pending_geometry.clear();
+            for (auto& [id, old_geometry] : pending)
+            {
+                auto it = described.find(id);
+                if (it == described.end())
+                {
+                    auto view = wf::ipc::find_view_by_id(id);
+                    it = described.emplace(id, std::nullopt).first;
+                    if (view)
+                    {
+                        it->second = ipc_rules::view_to_json(view);
+                    }
+                }
+
+                if (!it->second)
+                {
+                    // The view is gone
+                    continue;
+                }
+
+                wf::json_t data;
+                data["event"] = "view-geometry-changed";
+                data["old-geometry"] = wf::ipc::geometry_to_json(old_geometry);
+                data["view"] = *it->second;
+                client->send_json(std::move(data));
+            }
+        }
+    }
+
+    wf::signal::connection_t<wf::frame_done_signal> on_frame_done = [=] (wf::frame_done_signal *ev)
+    {
+        flush_all_pending_geometry();
+    };
+
+    void schedule_geometry_flush()
+    {
+        if (coalesce_timer.is_connected())
+        {
+            return;
+        }
+
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            wo->connect(&on_frame_done);
+        }
+
+        coalesce_timer.set_timeout(COALESCE_TIMEOUT_MS, [=] () { flush_all_pending_geometry(); });
+    }
+
     wf::signal::connection_t<wf::view_mapped_signal> on_view_mapped = [=] (wf::view_mapped_signal *ev)
     {
         send_view_to_subscribes(ev->view, "view-mapped");
@@ -268,32 +510,40 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     wf::signal::connection_t<wf::view_set_output_signal> on_view_set_output =
         [=] (wf::view_set_output_signal *ev)
     {
-        wf::json_t data;
-        data["event"]  = "view-set-output";
-        data["output"] = ipc_rules::output_to_json(ev->output);
-        data["view"]   = ipc_rules::view_to_json(ev->view);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("view-set-output", ev->view, nullptr, [&] ()
+        {
+            wf::json_t data;
+            data["event"]  = "view-set-output";
+            data["output"] = ipc_rules::output_to_json(ev->output);
+            data["view"]   = ipc_rules::view_to_json(ev->view);
+            return data;
+        });
     };
 
     // required by handle_new_output
     wf::signal::connection_t<wf::output_added_signal> on_output_added =
         [=] (wf::output_added_signal *ev)
     {
-        wf::json_t data;
-        data["event"]  = "output-added";
-        data["output"] = ipc_rules::output_to_json(ev->output);
-        send_event_to_subscribes(data, data["event"]);
+        send_output_to_subscribes(ev->output, "output-added");
     };
 
     wf::signal::connection_t<wf::output_removed_signal> on_output_removed =
         [=] (wf::output_removed_signal *ev)
     {
-        wf::json_t data;
-        data["event"]  = "output-removed";
-        data["output"] = ipc_rules::output_to_json(ev->output);
-        send_event_to_subscribes(data, data["event"]);
+        send_output_to_subscribes(ev->output, "output-removed");
     };
 
+    void send_output_to_subscribes(wf::output_t *output, std::string event_name)
+    {
+        send_event_to_subscribes(event_name, nullptr, output, [&] ()
+        {
+            wf::json_t data;
+            data["event"]  = event_name;
+            data["output"] = ipc_rules::output_to_json(output);
+            return data;
+        });
+    }
+
     wf::signal::connection_t<wf::output_layout_configuration_changed_signal> on_output_layout_changed =
         [=] (wf::output_layout_configuration_changed_signal *ev)
     {
@@ -334,22 +584,50 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
         [=] (wf::view_geometry_changed_signal *ev)
     {
-        wf::json_t data;
-        data["event"] = "view-geometry-changed";
-        data["old-geometry"] = wf::ipc::geometry_to_json(ev->old_geometry);
-        data["view"] = ipc_rules::view_to_json(ev->view);
-        send_event_to_subscribes(data, data["event"]);
+        static const std::string event_name = "view-geometry-changed";
+        std::optional<wf::json_t> data;
+        for (auto& [client, state] : clients)
+        {
+            if (!state.wants(event_name) || !state.filter.matches(ev->view, nullptr))
+            {
+                continue;
+            }
+
+            if (state.coalesce)
+            {
+                // Keep the geometry from before the first change, the view is described when sent.
+                auto& pending = state.pending_geometry;
+                uint32_t id   = ev->view->get_id();
+                if (std::none_of(pending.begin(), pending.end(), [&] (auto& p) { return p.first == id; }))
+                {
+                    pending.push_back({id, ev->old_geometry});
+                }
+
+                schedule_geometry_flush();
+                continue;
+            }
+
+            if (!data)
+            {
+                data = build_geometry_event(ev->view, ev->old_geometry);
+            }
+
+            client->send_json(*data);
+        }
     };
 
     wf::signal::connection_t<wf::view_moved_to_wset_signal> on_view_moved_to_wset =
         [=] (wf::view_moved_to_wset_signal *ev)
     {
-        wf::json_t data;
-        data["event"]    = "view-wset-changed";
-        data["old-wset"] = ipc_rules::wset_to_json(ev->old_wset.get());
-        data["new-wset"] = ipc_rules::wset_to_json(ev->new_wset.get());
-        data["view"]     = ipc_rules::view_to_json(ev->view);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("view-wset-changed", ev->view, nullptr, [&] ()
+        {
+            wf::json_t data;
+            data["event"]    = "view-wset-changed";
+            data["old-wset"] = ipc_rules::wset_to_json(ev->old_wset.get());
+            data["new-wset"] = ipc_rules::wset_to_json(ev->new_wset.get());
+            data["view"]     = ipc_rules::view_to_json(ev->view);
+            return data;
+        });
     };
 
     wf::signal::connection_t<wf::keyboard_focus_changed_signal> on_kbfocus_changed =
@@ -361,12 +639,15 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     // Tiled rule handler.
     wf::signal::connection_t<wf::view_tiled_signal> _tiled = [=] (wf::view_tiled_signal *ev)
     {
-        wf::json_t data;
-        data["event"]     = "view-tiled";
-        data["old-edges"] = ev->old_edges;
-        data["new-edges"] = ev->new_edges;
-        data["view"] = ipc_rules::view_to_json(ev->view);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("view-tiled", ev->view, nullptr, [&] ()
+        {
+            wf::json_t data;
+            data["event"]     = "view-tiled";
+            data["old-edges"] = ev->old_edges;
+            data["new-edges"] = ev->new_edges;
+            data["view"] = ipc_rules::view_to_json(ev->view);
+            return data;
+        });
     };
 
     // Minimized rule handler.
@@ -397,12 +678,15 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     wf::signal::connection_t<wf::view_change_workspace_signal> _view_workspace =
         [=] (wf::view_change_workspace_signal *ev)
     {
-        wf::json_t data;
-        data["event"] = "view-workspace-changed";
-        data["from"]  = wf::ipc::point_to_json(ev->from);
-        data["to"]    = wf::ipc::point_to_json(ev->to);
-        data["view"]  = ipc_rules::view_to_json(ev->view);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("view-workspace-changed", ev->view, nullptr, [&] ()
+        {
+            wf::json_t data;
+            data["event"] = "view-workspace-changed";
+            data["from"]  = wf::ipc::point_to_json(ev->from);
+            data["to"]    = wf::ipc::point_to_json(ev->to);
+            data["view"]  = ipc_rules::view_to_json(ev->view);
+            return data;
+        });
     };
 
     wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed =
@@ -420,22 +704,22 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     wf::signal::connection_t<wf::output_plugin_activated_changed_signal> on_plugin_activation_changed =
         [=] (wf::output_plugin_activated_changed_signal *ev)
     {
-        wf::json_t data;
-        data["event"]  = "plugin-activation-state-changed";
-        data["plugin"] = ev->plugin_name;
-        data["state"]  = ev->activated;
-        data["output"] = ev->output ? (int)ev->output->get_id() : -1;
-        data["output-data"] = ipc_rules::output_to_json(ev->output);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("plugin-activation-state-changed", nullptr, ev->output, [&] ()
+        {
+            wf::json_t data;
+            data["event"]  = "plugin-activation-state-changed";
+            data["plugin"] = ev->plugin_name;
+            data["state"]  = ev->activated;
+            data["output"] = ev->output ? (int)ev->output->get_id() : -1;
+            data["output-data"] = ipc_rules::output_to_json(ev->output);
+            return data;
+        });
     };
 
     wf::signal::connection_t<wf::output_gain_focus_signal> on_output_gain_focus =
         [=] (wf::output_gain_focus_signal *ev)
     {
-        wf::json_t data;
-        data["event"]  = "output-gain-focus";
-        data["output"] = ipc_rules::output_to_json(ev->output);
-        send_event_to_subscribes(data, data["event"]);
+        send_output_to_subscribes(ev->output, "output-gain-focus");
     };
 
     wf::signal::connection_t<wf::input_event_signal<mwlr_keyboard_modifiers_event>> on_keyboard_modifiers =
@@ -457,28 +741,34 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
     wf::signal::connection_t<wf::workspace_set_changed_signal> on_wset_changed =
         [=] (wf::workspace_set_changed_signal *ev)
     {
-        wf::json_t data;
-        data["event"]    = "output-wset-changed";
-        data["new-wset"] = ev->new_wset ? (int)ev->new_wset->get_id() : -1;
-        data["output"]   = ev->output ? (int)ev->output->get_id() : -1;
-        data["new-wset-data"] = ipc_rules::wset_to_json(ev->new_wset.get());
-        data["output-data"]   = ipc_rules::output_to_json(ev->output);
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("output-wset-changed", nullptr, ev->output, [&] ()
+        {
+            wf::json_t data;
+            data["event"]    = "output-wset-changed";
+            data["new-wset"] = ev->new_wset ? (int)ev->new_wset->get_id() : -1;
+            data["output"]   = ev->output ? (int)ev->output->get_id() : -1;
+            data["new-wset-data"] = ipc_rules::wset_to_json(ev->new_wset.get());
+            data["output-data"]   = ipc_rules::output_to_json(ev->output);
+            return data;
+        });
     };
 
     wf::signal::connection_t<wf::workspace_changed_signal> on_wset_workspace_changed =
         [=] (wf::workspace_changed_signal *ev)
     {
-        wf::json_t data;
-        data["event"] = "wset-workspace-changed";
-        data["previous-workspace"] = wf::ipc::point_to_json(ev->old_viewport);
-        data["new-workspace"] = wf::ipc::point_to_json(ev->new_viewport);
-        data["output"] = ev->output ? (int)ev->output->get_id() : -1;
-        data["wset"]   = (ev->output && ev->output->wset()) ? (int)ev->output->wset()->get_id() : -1;
-        data["output-data"] = ipc_rules::output_to_json(ev->output);
-        data["wset-data"]   =
-            ev->output ? ipc_rules::wset_to_json(ev->output->wset().get()) : json_t::null();
-        send_event_to_subscribes(data, data["event"]);
+        send_event_to_subscribes("wset-workspace-changed", nullptr, ev->output, [&] ()
+        {
+            wf::json_t data;
+            data["event"] = "wset-workspace-changed";
+            data["previous-workspace"] = wf::ipc::point_to_json(ev->old_viewport);
+            data["new-workspace"] = wf::ipc::point_to_json(ev->new_viewport);
+            data["output"] = ev->output ? (int)ev->output->get_id() : -1;
+            data["wset"]   = (ev->output && ev->output->wset()) ? (int)ev->output->wset()->get_id() : -1;
+            data["output-data"] = ipc_rules::output_to_json(ev->output);
+            data["wset-data"]   =
+                ev->output ? ipc_rules::wset_to_json(ev->output->wset().get()) : json_t::null();
+            return data;
+        });
     };
 
     class ipc_delay_object_t : public txn::transaction_object_t
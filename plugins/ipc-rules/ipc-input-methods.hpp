@@ -71,6 +71,12 @@ class ipc_rules_input_methods_t
 
             d["type"]    = wlr_input_device_type_to_string(device->get_wlr_handle()->type);
             d["enabled"] = device->is_enabled();
+            if (device->get_wlr_handle()->type == WLR_INPUT_DEVICE_POINTER)
+            {
+                d["motion-events"] = device->motion_stats.received;
+                d["merged-motion-events"] = device->motion_stats.merged;
+            }
+
             response.append(d);
         }
 
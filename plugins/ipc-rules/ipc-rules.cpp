@@ -16,18 +16,17 @@
 #include "ipc-input-methods.hpp"
 #include "ipc-utility-methods.hpp"
 #include "ipc-events.hpp"
+#include "ipc-snapshot.hpp"
 
 class ipc_rules_t : public wf::plugin_interface_t,
     public wf::ipc_rules_input_methods_t,
     public wf::ipc_rules_utility_methods_t,
-    public wf::ipc_rules_events_methods_t
+    public wf::ipc_rules_events_methods_t,
+    public wf::ipc_rules_snapshot_methods_t
 {
   public:
     void init() override
     {
-        method_repository->register_method("window-rules/list-views", list_views);
-        method_repository->register_method("window-rules/list-outputs", list_outputs);
-        method_repository->register_method("window-rules/list-wsets", list_wsets);
         method_repository->register_method("window-rules/view-info", get_view_info);
         method_repository->register_method("window-rules/output-info", get_output_info);
         method_repository->register_method("window-rules/wset-info", get_wset_info);
@@ -43,13 +42,11 @@ class ipc_rules_t : public wf::plugin_interface_t,
         init_input_methods(method_repository.get());
         init_utility_methods(method_repository.get());
         init_events(method_repository.get());
+        init_snapshot(method_repository.get());
     }
 
     void fini() override
     {
-        method_repository->unregister_method("window-rules/list-views");
-        method_repository->unregister_method("window-rules/list-outputs");
-        method_repository->unregister_method("window-rules/list-wsets");
         method_repository->unregister_method("window-rules/view-info");
         method_repository->unregister_method("window-rules/output-info");
         method_repository->unregister_method("window-rules/wset-info");
@@ -65,20 +62,9 @@ class ipc_rules_t : public wf::plugin_interface_t,
         fini_input_methods(method_repository.get());
         fini_utility_methods(method_repository.get());
         fini_events(method_repository.get());
+        fini_snapshot(method_repository.get());
     }
 
-    wf::ipc::method_callback list_views = [=] (wf::json_t)
-    {
-        wf::json_t response = wf::json_t::array();
-        for (auto& view : wf::get_core().get_all_views())
-        {
-            wf::json_t v = wf::ipc_rules::view_to_json(view);
-            response.append(v);
-        }
-
-        return response;
-    };
-
     wf::ipc::method_callback get_view_info = [=] (wf::json_t data)
     {
         auto view     = wf::ipc::json_find_view_or_throw(data);
@@ -239,17 +225,6 @@ class ipc_rules_t : public wf::plugin_interface_t,
         return wf::ipc::json_error("property has unsupported type");
     };
 
-    wf::ipc::method_callback list_outputs = [=] (wf::json_t)
-    {
-        wf::json_t response = wf::json_t::array();
-        for (auto& output : wf::get_core().output_layout->get_outputs())
-        {
-            response.append(wf::ipc_rules::output_to_json(output));
-        }
-
-        return response;
-    };
-
     wf::ipc::method_callback get_output_info = [=] (wf::json_t data)
     {
         auto id = wf::ipc::json_get_uint64(data, "id");
@@ -331,20 +306,11 @@ class ipc_rules_t : public wf::plugin_interface_t,
             toplevel->set_sticky(sticky.value());
         }
 
+        // The pending state is listed before it is committed
+        invalidate_view(view);
         return wf::ipc::json_ok();
     };
 
-    wf::ipc::method_callback list_wsets = [=] (wf::json_t)
-    {
-        wf::json_t response = wf::json_t::array();
-        for (auto& workspace_set : wf::workspace_set_t::get_all())
-        {
-            response.append(wf::ipc_rules::wset_to_json(workspace_set.get()));
-        }
-
-        return response;
-    };
-
     wf::ipc::method_callback get_wset_info = [=] (wf::json_t data)
     {
         auto id = wf::ipc::json_get_uint64(data, "id");
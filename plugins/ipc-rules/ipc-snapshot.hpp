@@ -0,0 +1,433 @@
+#pragma once
+
+#include "ipc-rules-common.hpp"
+#include <set>
+#include <unordered_map>
+#include "wayfire/output-layout.hpp"
+#include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include "wayfire/seat.hpp"
+#include <wayfire/signal-definitions.hpp>
+#include "plugins/wm-actions/wm-actions-signals.hpp"
+
+namespace wf
+{
+namespace ipc_rules
+{
+/**
+ * A versioned cache of the JSON descriptions of one kind of objects (views, outputs or workspace sets).
+ *
+ * Descriptions are rebuilt lazily: signals only mark entries as dirty, and the next query rebuilds the dirty
+ * entries and reuses the cached JSON of all others. Every rebuilt, added or removed entry gets a new version,
+ * so that clients can ask only for the changes since the last version they have seen.
+ */
+class snapshot_table_t
+{
+  public:
+    /** How many removed entries are remembered for delta queries. */
+    static constexpr size_t MAX_REMOVED = 256;
+
+    void invalidate(uint64_t id)
+    {
+        dirty.insert(id);
+    }
+
+    void invalidate_all()
+    {
+        all_dirty = true;
+    }
+
+    /**
+     * Bring the table up to date with the current list of objects.
+     *
+     * @param version The version counter, shared between all tables of a snapshot.
+     * @param get_id Returns the id of an object.
+     * @param describe Builds the JSON description of an object.
+     */
+    template<class Object, class GetId, class Describe>
+    void refresh(const std::vector<Object>& objects, uint64_t& version, GetId get_id, Describe describe)
+    {
+        std::vector<uint64_t> new_order;
+        new_order.reserve(objects.size());
+        for (auto& object : objects)
+        {
+            uint64_t id = get_id(object);
+            new_order.push_back(id);
+
+            auto it = entries.find(id);
+            if ((it == entries.end()) || all_dirty || dirty.count(id))
+            {
+                entries[id] = entry_t{describe(object), ++version};
+            }
+        }
+
+        // Entries of all current objects exist now, so any extra entries belong to removed objects.
+        if (entries.size() > new_order.size())
+        {
+            std::set<uint64_t> alive(new_order.begin(), new_order.end());
+            for (auto& id : order)
+            {
+                if (!alive.count(id) && entries.erase(id))
+                {
+                    removed.push_back({id, ++version});
+                }
+            }
+
+            if (removed.size() > MAX_REMOVED)
+            {
+                oldest_removed = removed[removed.size() - MAX_REMOVED - 1].second;
+                removed.erase(removed.begin(), removed.end() - MAX_REMOVED);
+            }
+        }
+
+        order     = std::move(new_order);
+        all_dirty = false;
+        dirty.clear();
+    }
+
+    /** The descriptions of all objects. */
+    wf::json_t list() const
+    {
+        wf::json_t response = wf::json_t::array();
+        for (auto& id : order)
+        {
+            response.append(entries.at(id).json);
+        }
+
+        return response;
+    }
+
+    /**
+     * The descriptions of all objects changed or added after version @since, and the ids of objects removed
+     * after it. If some of the removed objects are no longer remembered, all objects are reported as changed
+     * and "reset" is set, so that the client can drop everything it has not received again.
+     */
+    wf::json_t delta(uint64_t since) const
+    {
+        bool reset = since < oldest_removed;
+
+        wf::json_t response;
+        response["reset"]   = reset;
+        response["changed"] = wf::json_t::array();
+        response["removed"] = wf::json_t::array();
+        for (auto& id : order)
+        {
+            auto& entry = entries.at(id);
+            if (reset || (entry.version > since))
+            {
+                response["changed"].append(entry.json);
+            }
+        }
+
+        if (!reset)
+        {
+            for (auto& [id, version] : removed)
+            {
+                if (version > since)
+                {
+                    response["removed"].append(id);
+                }
+            }
+        }
+
+        return response;
+    }
+
+  private:
+    struct entry_t
+    {
+        wf::json_t json;
+        uint64_t version;
+    };
+
+    std::unordered_map<uint64_t, entry_t> entries;
+    /* The ids of the objects, in the order they are listed */
+    std::vector<uint64_t> order;
+    /* Removed ids with the version at which they were removed, oldest first */
+    std::vector<std::pair<uint64_t, uint64_t>> removed;
+    /* Removals up to this version have been forgotten */
+    uint64_t oldest_removed = 0;
+
+    std::set<uint64_t> dirty;
+    bool all_dirty = true;
+};
+
+/**
+ * The parts of a view's description which can change without any signal on core or on the output: the
+ * parent (announced only on the view), the bounding box (transformers), size hints, the layer and geometry
+ * which other plugins set but did not commit yet. They are cheap to get, so they are compared on every query
+ * and the view is described anew if any of them changed.
+ */
+struct view_untracked_state_t
+{
+    int64_t parent = -1;
+    wf::geometry_t geometry;
+    wf::geometry_t bbox;
+    wf::geometry_t base_geometry;
+    std::optional<wf::scene::layer> layer;
+    wf::dimensions_t min_size = {0, 0};
+    wf::dimensions_t max_size = {0, 0};
+    bool focusable = false;
+
+    static view_untracked_state_t get(wayfire_view view)
+    {
+        view_untracked_state_t state;
+        auto toplevel = wf::toplevel_cast(view);
+        if (toplevel)
+        {
+            state.parent   = toplevel->parent ? (int64_t)toplevel->parent->get_id() : -1;
+            state.geometry = toplevel->get_pending_geometry();
+            state.min_size = toplevel->toplevel()->get_min_size();
+            state.max_size = toplevel->toplevel()->get_max_size();
+        } else
+        {
+            state.geometry = view->get_bounding_box();
+        }
+
+        state.bbox = view->get_bounding_box();
+        state.base_geometry = get_view_base_geometry(view);
+        state.layer = wf::get_view_layer(view);
+        state.focusable = view->is_focusable();
+        return state;
+    }
+
+    bool operator ==(const view_untracked_state_t& other) const
+    {
+        return (parent == other.parent) && (geometry == other.geometry) && (bbox == other.bbox) &&
+               (base_geometry == other.base_geometry) && (layer == other.layer) &&
+               (min_size == other.min_size) && (max_size == other.max_size) && (focusable == other.focusable);
+    }
+
+    bool operator !=(const view_untracked_state_t& other) const
+    {
+        return !(*this == other);
+    }
+};
+}
+
+/**
+ * Implements window-rules/list-views, list-outputs and list-wsets on top of a cached, versioned snapshot.
+ *
+ * Without arguments, each method returns the full list, like before. With a "since" argument, it returns only
+ * the entries which changed after the given version, together with the current version:
+ * {"version": N, "reset": false, "changed": [...], "removed": [ids]}. Clients start with since=0.
+ */
+class ipc_rules_snapshot_methods_t
+{
+  public:
+    void init_snapshot(ipc::method_repository_t *method_repository)
+    {
+        method_repository->register_method("window-rules/list-views", list_views);
+        method_repository->register_method("window-rules/list-outputs", list_outputs);
+        method_repository->register_method("window-rules/list-wsets", list_wsets);
+
+        wf::get_core().connect(&on_view_mapped);
+        wf::get_core().connect(&on_view_unmapped);
+        wf::get_core().connect(&on_view_set_output);
+        wf::get_core().connect(&on_view_geometry_changed);
+        wf::get_core().connect(&on_view_moved_to_wset);
+        wf::get_core().connect(&on_title_changed);
+        wf::get_core().connect(&on_app_id_changed);
+        wf::get_core().connect(&on_kbfocus_changed);
+        wf::get_core().connect(&on_reload_config);
+        wf::get_core().output_layout->connect(&on_output_layout_changed);
+        wf::get_core().output_layout->connect(&on_output_added);
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            connect_output(wo);
+        }
+    }
+
+    void fini_snapshot(ipc::method_repository_t *method_repository)
+    {
+        method_repository->unregister_method("window-rules/list-views");
+        method_repository->unregister_method("window-rules/list-outputs");
+        method_repository->unregister_method("window-rules/list-wsets");
+    }
+
+    /**
+     * Make sure the next query describes the view anew. Needed for changes which are not announced with
+     * a signal, like a pending geometry which has not been committed yet.
+     */
+    void invalidate_view(wayfire_view view)
+    {
+        views.invalidate(view->get_id());
+    }
+
+  private:
+    uint64_t version = 0;
+    ipc_rules::snapshot_table_t views;
+    ipc_rules::snapshot_table_t outputs;
+    ipc_rules::snapshot_table_t wsets;
+
+    /* The last view which received keyboard focus. Its activated state changes with the next focus change. */
+    uint64_t last_focused_id = 0;
+
+    /* The untracked state of each view when it was last described */
+    std::unordered_map<uint64_t, ipc_rules::view_untracked_state_t> untracked_state;
+
+    void invalidate_changed_untracked_state(const std::vector<wayfire_view>& all_views)
+    {
+        std::unordered_map<uint64_t, ipc_rules::view_untracked_state_t> new_state;
+        for (auto& view : all_views)
+        {
+            auto state = ipc_rules::view_untracked_state_t::get(view);
+            auto it    = untracked_state.find(view->get_id());
+            if ((it == untracked_state.end()) || (it->second != state))
+            {
+                views.invalidate(view->get_id());
+            }
+
+            new_state[view->get_id()] = state;
+        }
+
+        untracked_state = std::move(new_state);
+    }
+
+    static wf::json_t build_response(const ipc_rules::snapshot_table_t& table,
+        const wf::json_t& data, uint64_t version)
+    {
+        auto since = wf::ipc::json_get_optional_uint64(data, "since");
+        if (!since.has_value())
+        {
+            return table.list();
+        }
+
+        auto response = table.delta(since.value());
+        response["version"] = version;
+        return response;
+    }
+
+    wf::ipc::method_callback list_views = [=] (wf::json_t data)
+    {
+        auto all_views = wf::get_core().get_all_views();
+        invalidate_changed_untracked_state(all_views);
+        views.refresh(all_views, version,
+            [] (wayfire_view view) { return view->get_id(); }, ipc_rules::view_to_json);
+        return build_response(views, data, version);
+    };
+
+    wf::ipc::method_callback list_outputs = [=] (wf::json_t data)
+    {
+        outputs.refresh(wf::get_core().output_layout->get_outputs(), version,
+            [] (wf::output_t *wo) { return wo->get_id(); }, ipc_rules::output_to_json);
+        return build_response(outputs, data, version);
+    };
+
+    wf::ipc::method_callback list_wsets = [=] (wf::json_t data)
+    {
+        wsets.refresh(wf::workspace_set_t::get_all(), version,
+            [] (nonstd::observer_ptr<wf::workspace_set_t> wset) { return wset->get_index(); },
+            [] (nonstd::observer_ptr<wf::workspace_set_t> wset)
+        {
+            return ipc_rules::wset_to_json(wset.get());
+        });
+        return build_response(wsets, data, version);
+    };
+
+    void connect_output(wf::output_t *wo)
+    {
+        // A connection can be connected to many outputs, and is disconnected when an output is destroyed.
+        wo->connect(&on_view_minimized);
+        wo->connect(&on_view_tiled);
+        wo->connect(&on_view_fullscreen);
+        wo->connect(&on_view_sticky);
+        wo->connect(&on_view_above);
+        wo->connect(&on_view_workspace);
+        wo->connect(&on_workarea_changed);
+        wo->connect(&on_wset_changed);
+        wo->connect(&on_workspace_changed);
+    }
+
+    void invalidate_outputs_and_wsets()
+    {
+        outputs.invalidate_all();
+        wsets.invalidate_all();
+    }
+
+    template<class Signal>
+    wf::signal::connection_t<Signal> invalidate_view_on()
+    {
+        return [=] (Signal *ev)
+        {
+            if (ev->view)
+            {
+                invalidate_view(ev->view);
+            }
+        };
+    }
+
+    wf::signal::connection_t<wf::view_mapped_signal> on_view_mapped =
+        invalidate_view_on<wf::view_mapped_signal>();
+    wf::signal::connection_t<wf::view_unmapped_signal> on_view_unmapped =
+        invalidate_view_on<wf::view_unmapped_signal>();
+    wf::signal::connection_t<wf::view_set_output_signal> on_view_set_output =
+        invalidate_view_on<wf::view_set_output_signal>();
+    wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
+        invalidate_view_on<wf::view_geometry_changed_signal>();
+    wf::signal::connection_t<wf::view_moved_to_wset_signal> on_view_moved_to_wset =
+        invalidate_view_on<wf::view_moved_to_wset_signal>();
+    wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed =
+        invalidate_view_on<wf::view_title_changed_signal>();
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed =
+        invalidate_view_on<wf::view_app_id_changed_signal>();
+    wf::signal::connection_t<wf::view_minimized_signal> on_view_minimized =
+        invalidate_view_on<wf::view_minimized_signal>();
+    wf::signal::connection_t<wf::view_tiled_signal> on_view_tiled =
+        invalidate_view_on<wf::view_tiled_signal>();
+    wf::signal::connection_t<wf::view_fullscreen_signal> on_view_fullscreen =
+        invalidate_view_on<wf::view_fullscreen_signal>();
+    wf::signal::connection_t<wf::view_set_sticky_signal> on_view_sticky =
+        invalidate_view_on<wf::view_set_sticky_signal>();
+    wf::signal::connection_t<wf::wm_actions_above_changed_signal> on_view_above =
+        invalidate_view_on<wf::wm_actions_above_changed_signal>();
+    wf::signal::connection_t<wf::view_change_workspace_signal> on_view_workspace =
+        invalidate_view_on<wf::view_change_workspace_signal>();
+
+    wf::signal::connection_t<wf::keyboard_focus_changed_signal> on_kbfocus_changed =
+        [=] (wf::keyboard_focus_changed_signal *ev)
+    {
+        // Focus changes the activated state and focus timestamp of the old and the new view
+        views.invalidate(last_focused_id);
+        if (auto view = wf::node_to_view(ev->new_focus))
+        {
+            last_focused_id = view->get_id();
+            views.invalidate(last_focused_id);
+        }
+    };
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        connect_output(ev->output);
+    };
+
+    wf::signal::connection_t<wf::output_layout_configuration_changed_signal> on_output_layout_changed =
+        [=] (wf::output_layout_configuration_changed_signal *ev)
+    {
+        outputs.invalidate_all();
+    };
+
+    wf::signal::connection_t<wf::workarea_changed_signal> on_workarea_changed =
+        [=] (wf::workarea_changed_signal *ev)
+    {
+        outputs.invalidate(ev->output->get_id());
+    };
+
+    wf::signal::connection_t<wf::workspace_set_changed_signal> on_wset_changed =
+        [=] (wf::workspace_set_changed_signal *ev)
+    {
+        invalidate_outputs_and_wsets();
+    };
+
+    wf::signal::connection_t<wf::workspace_changed_signal> on_workspace_changed =
+        [=] (wf::workspace_changed_signal *ev)
+    {
+        invalidate_outputs_and_wsets();
+    };
+
+    // Workspace grid size changes are not announced on outputs, they happen on a configuration reload.
+    wf::signal::connection_t<wf::reload_config_signal> on_reload_config = [=] (wf::reload_config_signal *ev)
+    {
+        invalidate_outputs_and_wsets();
+    };
+};
+}
@@ -10,6 +10,9 @@
 #include <wayfire/output-layout.hpp>
 #include <wayfire/config/compound-option.hpp>
 #include <wayfire/config/config-manager.hpp>
+#include <wayfire/img.hpp>
+#include <wayfire/render.hpp>
+#include <wayfire/scene.hpp>
 
 extern "C" {
 #include <wlr/backend/headless.h>
@@ -35,6 +38,7 @@ class ipc_rules_utility_methods_t
         method_repository->register_method("wayfire/set-config-options", set_config_options);
         method_repository->register_method("wayfire/get-keyboard-state", get_kb_state);
         method_repository->register_method("wayfire/set-keyboard-state", set_kb_state);
+        method_repository->register_method("wayfire/capture-output", capture_output);
     }
 
     void fini_utility_methods(ipc::method_repository_t *method_repository)
@@ -47,6 +51,7 @@ class ipc_rules_utility_methods_t
         method_repository->unregister_method("wayfire/set-config-option");
         method_repository->unregister_method("wayfire/get-keyboard-state");
         method_repository->unregister_method("wayfire/set-keyboard-state");
+        method_repository->unregister_method("wayfire/capture-output");
     }
 
     wf::ipc::method_callback get_wayfire_configuration_info = [=] (wf::json_t)
@@ -119,6 +124,53 @@ class ipc_rules_utility_methods_t
         return wf::ipc::json_ok();
     };
 
+    /**
+     * Render the current contents of an output and save them to a file.
+     * The file is encoded and written in the background, so the call returns before the file is complete.
+     */
+    wf::ipc::method_callback capture_output = [=] (const wf::json_t& data)
+    {
+        auto output_id = wf::ipc::json_get_uint64(data, "output-id");
+        auto file = wf::ipc::json_get_string(data, "file");
+        auto format_name = wf::ipc::json_get_optional_string(data, "format").value_or("png");
+
+        auto format = image_io::parse_image_format(format_name);
+        if (!format.has_value())
+        {
+            return wf::ipc::json_error("Unknown format " + format_name + ", expected png, qoi or raw!");
+        }
+
+        auto wo = wf::ipc::find_output_by_id(output_id);
+        if (!wo)
+        {
+            return wf::ipc::json_error("Output not found!");
+        }
+
+        const wf::geometry_t box = wo->get_layout_geometry();
+        const float scale = wo->handle->scale;
+
+        wf::auxilliary_buffer_t buffer;
+        buffer.allocate(wf::dimensions(box), scale);
+
+        wf::render_target_t target{buffer};
+        target.geometry = box;
+        target.scale    = scale;
+
+        std::vector<scene::render_instance_uptr> instances;
+        wf::get_core().scene()->gen_render_instances(instances, [] (auto) {}, wo);
+
+        wf::render_pass_params_t params;
+        params.background_color = {0, 0, 0, 1};
+        params.damage    = box;
+        params.target    = target;
+        params.instances = &instances;
+        params.flags     = RPASS_CLEAR_BACKGROUND;
+        wf::render_pass_t::run(params);
+
+        image_io::write_to_file_async(file, buffer.get_renderbuffer(), format.value());
+        return wf::ipc::json_ok();
+    };
+
     wf::json_t option_value_to_json(const std::shared_ptr<wf::config::option_base_t>& option)
     {
         if (auto compound = std::dynamic_pointer_cast<wf::config::compound_option_t>(option))
@@ -12,6 +12,8 @@
 #include "src/view/view-impl.hpp"
 #include <variant>
 #include <cstring>
+#include <chrono>
+#include <map>
 
 #define WAYFIRE_PLUGIN
 #include <wayfire/debug.hpp>
@@ -175,7 +177,29 @@ class headless_input_backend_t
         *y = 1.0 * (*y - box.y) / box.height;
     }
 
+    struct touch_point_t
+    {
+        int finger;
+        double x, y;
+    };
+
+    /** Press or move several fingers, and send a single frame event for all of them. */
+    void do_touch_frame(const std::vector<touch_point_t>& points)
+    {
+        for (auto& point : points)
+        {
+            emit_touch(point.finger, point.x, point.y);
+        }
+
+        wl_signal_emit(&touch.events.frame, NULL);
+    }
+
     void do_touch(int finger, double x, double y)
+    {
+        do_touch_frame({{finger, x, y}});
+    }
+
+    void emit_touch(int finger, double x, double y)
     {
         convert_xy_to_relative(&x, &y);
         if (!wf::get_core().get_touch_state().fingers.count(finger))
@@ -197,8 +221,6 @@ class headless_input_backend_t
             ev.touch_id = finger;
             wl_signal_emit(&touch.events.motion, &ev);
         }
-
-        wl_signal_emit(&touch.events.frame, NULL);
     }
 
     void do_touch_release(int finger)
@@ -280,6 +302,274 @@ class headless_input_backend_t
     headless_input_backend_t& operator =(headless_input_backend_t&&) = delete;
 };
 
+static int64_t now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Summarize durations (in microseconds).
+ */
+static wf::json_t stats_to_json(std::vector<int64_t> values)
+{
+    wf::json_t stats;
+    stats["count"] = (int64_t)values.size();
+    if (values.empty())
+    {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto& percentile = [&] (int p)
+    {
+        return values[std::min(values.size() - 1, values.size() * p / 100)];
+    };
+
+    int64_t sum = 0;
+    for (auto v : values)
+    {
+        sum += v;
+    }
+
+    stats["min"]  = values.front();
+    stats["max"]  = values.back();
+    stats["mean"] = (double)sum / values.size();
+    stats["p50"]  = percentile(50);
+    stats["p90"]  = percentile(90);
+    stats["p99"]  = percentile(99);
+    return stats;
+}
+
+/**
+ * Measures the latency from injecting an input event to the next output commit.
+ *
+ * Each sample injects a single event through the headless input backend, and records when the event arrives
+ * at core (dispatch), when core has finished processing it (handle, which includes finding the focused node
+ * and running the bindings), and when an output commits the next frame (commit). The next sample is
+ * injected after the commit, or after a timeout if no frame was committed.
+ */
+class latency_benchmark_t
+{
+  public:
+    enum class event_kind_t
+    {
+        MOTION,
+        BUTTON,
+        KEY,
+    };
+
+    struct params_t
+    {
+        event_kind_t kind = event_kind_t::MOTION;
+        int nr_samples    = 100;
+        // Time to wait for a commit before moving on to the next sample, in milliseconds.
+        int timeout = 100;
+        // Motion events alternate between these two points.
+        wf::pointf_t from = {0, 0};
+        wf::pointf_t to   = {100, 100};
+    };
+
+    latency_benchmark_t(headless_input_backend_t *input, params_t params)
+    {
+        this->input  = input;
+        this->params = params;
+        samples.reserve(params.nr_samples);
+
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            watch_output(wo);
+        }
+
+        wf::get_core().output_layout->connect(&on_output_added);
+        wf::get_core().output_layout->connect(&on_output_pre_remove);
+        switch (params.kind)
+        {
+          case event_kind_t::MOTION:
+            wf::get_core().connect(&on_motion);
+            wf::get_core().connect(&on_motion_done);
+            break;
+
+          case event_kind_t::BUTTON:
+            wf::get_core().connect(&on_button);
+            wf::get_core().connect(&on_button_done);
+            break;
+
+          case event_kind_t::KEY:
+            wf::get_core().connect(&on_key);
+            wf::get_core().connect(&on_key_done);
+            break;
+        }
+
+        next_sample.run_once([=] () { inject_next(); });
+    }
+
+    bool is_running() const
+    {
+        return running;
+    }
+
+    wf::json_t get_results() const
+    {
+        std::vector<int64_t> dispatch, handle, commit;
+        for (const auto& sample : samples)
+        {
+            if (sample.handled < 0)
+            {
+                continue;
+            }
+
+            dispatch.push_back(sample.dispatched - sample.injected);
+            handle.push_back(sample.handled - sample.injected);
+            if (sample.committed >= 0)
+            {
+                commit.push_back(sample.committed - sample.injected);
+            }
+        }
+
+        auto response = wf::ipc::json_ok();
+        response["running"] = running;
+        response["samples"] = (int64_t)samples.size();
+        response["missed-commits"] = (int64_t)(handle.size() - commit.size());
+        response["dispatch"] = stats_to_json(dispatch);
+        response["handle"]   = stats_to_json(handle);
+        response["commit"]   = stats_to_json(commit);
+        return response;
+    }
+
+  private:
+    struct sample_t
+    {
+        // Timestamps in microseconds, -1 if the stage was not reached.
+        int64_t injected   = -1;
+        int64_t dispatched = -1;
+        int64_t handled    = -1;
+        int64_t committed  = -1;
+    };
+
+    headless_input_backend_t *input;
+    params_t params;
+    std::vector<sample_t> samples;
+    bool running = true;
+    bool waiting_for_commit = false;
+
+    wf::wl_idle_call next_sample;
+    wf::wl_timer<false> commit_timeout;
+    std::map<wf::output_t*, std::unique_ptr<wf::wl_listener_wrapper>> on_commit;
+
+    void inject_next()
+    {
+        if ((int)samples.size() >= params.nr_samples)
+        {
+            finish();
+            return;
+        }
+
+        const bool odd = samples.size() % 2;
+        samples.emplace_back();
+        samples.back().injected = now_us();
+        waiting_for_commit = true;
+
+        const auto& target = odd ? params.from : params.to;
+        switch (params.kind)
+        {
+          case event_kind_t::MOTION:
+            input->do_motion(target.x, target.y);
+            break;
+
+          case event_kind_t::BUTTON:
+            input->do_button(BTN_LEFT,
+                odd ? WL_POINTER_BUTTON_STATE_RELEASED : WL_POINTER_BUTTON_STATE_PRESSED);
+            break;
+
+          case event_kind_t::KEY:
+            input->do_key(KEY_LEFTSHIFT,
+                odd ? WL_KEYBOARD_KEY_STATE_RELEASED : WL_KEYBOARD_KEY_STATE_PRESSED);
+            break;
+        }
+
+        commit_timeout.set_timeout(params.timeout, [=] ()
+        {
+            waiting_for_commit = false;
+            next_sample.run_once([=] () { inject_next(); });
+        });
+    }
+
+    void finish()
+    {
+        running = false;
+        commit_timeout.disconnect();
+        on_commit.clear();
+        on_output_added.disconnect();
+        on_output_pre_remove.disconnect();
+        on_motion.disconnect();
+        on_motion_done.disconnect();
+        on_button.disconnect();
+        on_button_done.disconnect();
+        on_key.disconnect();
+        on_key_done.disconnect();
+    }
+
+    void watch_output(wf::output_t *wo)
+    {
+        auto listener = std::make_unique<wf::wl_listener_wrapper>();
+        listener->set_callback([=] (void*)
+        {
+            if (!waiting_for_commit || samples.empty() || (samples.back().handled < 0))
+            {
+                return;
+            }
+
+            samples.back().committed = now_us();
+            waiting_for_commit = false;
+            commit_timeout.disconnect();
+            next_sample.run_once([=] () { inject_next(); });
+        });
+        listener->connect(&wo->handle->events.commit);
+        on_commit[wo] = std::move(listener);
+    }
+
+    void mark_dispatched()
+    {
+        if (waiting_for_commit && (samples.back().dispatched < 0))
+        {
+            samples.back().dispatched = now_us();
+        }
+    }
+
+    void mark_handled()
+    {
+        if (waiting_for_commit && (samples.back().handled < 0))
+        {
+            samples.back().handled = now_us();
+        }
+    }
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        watch_output(ev->output);
+    };
+
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_output_pre_remove =
+        [=] (wf::output_pre_remove_signal *ev)
+    {
+        on_commit.erase(ev->output);
+    };
+
+    wf::signal::connection_t<wf::input_event_signal<wlr_pointer_motion_event>> on_motion =
+        [=] (auto) { mark_dispatched(); };
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion_done =
+        [=] (auto) { mark_handled(); };
+    wf::signal::connection_t<wf::input_event_signal<wlr_pointer_button_event>> on_button =
+        [=] (auto) { mark_dispatched(); };
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_button_event>> on_button_done =
+        [=] (auto) { mark_handled(); };
+    wf::signal::connection_t<wf::input_event_signal<wlr_keyboard_key_event>> on_key =
+        [=] (auto) { mark_dispatched(); };
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_keyboard_key_event>> on_key_done =
+        [=] (auto) { mark_handled(); };
+};
+
 class stipc_plugin_t : public wf::plugin_interface_t
 {
     wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> method_repository;
@@ -299,6 +589,7 @@ class stipc_plugin_t : public wf::plugin_interface_t
         method_repository->register_method("stipc/layout_views", layout_views);
         method_repository->register_method("stipc/touch", do_touch);
         method_repository->register_method("stipc/touch_release", do_touch_release);
+        method_repository->register_method("stipc/touch/benchmark", touch_benchmark);
         method_repository->register_method("stipc/tablet/tool_proximity", do_tool_proximity);
         method_repository->register_method("stipc/tablet/tool_button", do_tool_button);
         method_repository->register_method("stipc/tablet/tool_axis", do_tool_axis);
@@ -307,6 +598,8 @@ class stipc_plugin_t : public wf::plugin_interface_t
         method_repository->register_method("stipc/delay_next_tx", delay_next_tx);
         method_repository->register_method("stipc/get_xwayland_pid", get_xwayland_pid);
         method_repository->register_method("stipc/get_xwayland_display", get_xwayland_display);
+        method_repository->register_method("stipc/latency/start", start_latency_benchmark);
+        method_repository->register_method("stipc/latency/results", get_latency_results);
     }
 
     bool is_unloadable() override
@@ -504,12 +797,35 @@ class stipc_plugin_t : public wf::plugin_interface_t
         return wf::ipc::json_ok();
     };
 
-    ipc::method_callback do_touch = [=] (wf::json_t data)
+    /**
+     * Either press or move a single finger ("finger", "x", "y"), or several fingers in the same frame
+     * ("points": [{"finger", "x", "y"}, ...]).
+     */
+    ipc::method_callback do_touch = [=] (wf::json_t data) -> wf::json_t
     {
-        auto finger = wf::ipc::json_get_int64(data, "finger");
-        auto x = wf::ipc::json_get_double(data, "x");
-        auto y = wf::ipc::json_get_double(data, "y");
-        input->do_touch(finger, x, y);
+        if (!data.has_member("points"))
+        {
+            auto finger = wf::ipc::json_get_int64(data, "finger");
+            auto x = wf::ipc::json_get_double(data, "x");
+            auto y = wf::ipc::json_get_double(data, "y");
+            input->do_touch(finger, x, y);
+            return wf::ipc::json_ok();
+        }
+
+        if (!data["points"].is_array())
+        {
+            return wf::ipc::json_error("points must be an array");
+        }
+
+        std::vector<headless_input_backend_t::touch_point_t> points;
+        for (size_t i = 0; i < data["points"].size(); i++)
+        {
+            const auto& p = data["points"][i];
+            points.push_back({(int)wf::ipc::json_get_int64(p, "finger"),
+                wf::ipc::json_get_double(p, "x"), wf::ipc::json_get_double(p, "y")});
+        }
+
+        input->do_touch_frame(points);
         return wf::ipc::json_ok();
     };
 
@@ -520,6 +836,74 @@ class stipc_plugin_t : public wf::plugin_interface_t
         return wf::ipc::json_ok();
     };
 
+    /**
+     * Press `fingers` fingers next to each other at (x, y), move all of them by (dx, dy) in each of `frames`
+     * frames, and release them. Reports how long core took to process each frame of motion events, in
+     * microseconds.
+     */
+    ipc::method_callback touch_benchmark = [=] (wf::json_t data)
+    {
+        const int fingers = wf::ipc::json_get_optional_int64(data, "fingers").value_or(3);
+        const int frames  = wf::ipc::json_get_optional_int64(data, "frames").value_or(100);
+        double x = wf::ipc::json_get_optional_double(data, "x").value_or(100);
+        double y = wf::ipc::json_get_optional_double(data, "y").value_or(100);
+        const double dx = wf::ipc::json_get_optional_double(data, "dx").value_or(1);
+        const double dy = wf::ipc::json_get_optional_double(data, "dy").value_or(0);
+        // Distance between neighbouring fingers
+        const double spacing = wf::ipc::json_get_optional_double(data, "spacing").value_or(50);
+        if ((fingers <= 0) || (frames <= 0))
+        {
+            return wf::ipc::json_error("`fingers` and `frames` must be positive!");
+        }
+
+        if (!wf::get_core().get_touch_state().fingers.empty())
+        {
+            return wf::ipc::json_error("Some fingers are already down!");
+        }
+
+        const auto& make_points = [&] ()
+        {
+            std::vector<headless_input_backend_t::touch_point_t> points;
+            for (int i = 0; i < fingers; i++)
+            {
+                points.push_back({i, x + i * spacing, y});
+            }
+
+            return points;
+        };
+
+        int64_t start = now_us();
+        input->do_touch_frame(make_points());
+        const int64_t down = now_us() - start;
+
+        std::vector<int64_t> frame_times;
+        frame_times.reserve(frames);
+        for (int i = 0; i < frames; i++)
+        {
+            x += dx;
+            y += dy;
+            auto points = make_points();
+
+            start = now_us();
+            input->do_touch_frame(points);
+            frame_times.push_back(now_us() - start);
+        }
+
+        start = now_us();
+        for (int i = 0; i < fingers; i++)
+        {
+            input->do_touch_release(i);
+        }
+
+        const int64_t up = now_us() - start;
+
+        auto response = wf::ipc::json_ok();
+        response["down"]   = down;
+        response["up"]     = up;
+        response["frames"] = stats_to_json(frame_times);
+        return response;
+    };
+
     ipc::method_callback run = [=] (wf::json_t data)
     {
         auto cmd = wf::ipc::json_get_string(data, "cmd");
@@ -643,6 +1027,56 @@ class stipc_plugin_t : public wf::plugin_interface_t
         return response;
     };
 
+    std::unique_ptr<latency_benchmark_t> latency_benchmark;
+    ipc::method_callback start_latency_benchmark = [=] (wf::json_t data)
+    {
+        if (latency_benchmark && latency_benchmark->is_running())
+        {
+            return wf::ipc::json_error("A latency benchmark is already running!");
+        }
+
+        latency_benchmark_t::params_t params;
+        auto kind = wf::ipc::json_get_optional_string(data, "kind").value_or("motion");
+        if (kind == "motion")
+        {
+            params.kind = latency_benchmark_t::event_kind_t::MOTION;
+        } else if (kind == "button")
+        {
+            params.kind = latency_benchmark_t::event_kind_t::BUTTON;
+        } else if (kind == "key")
+        {
+            params.kind = latency_benchmark_t::event_kind_t::KEY;
+        } else
+        {
+            return wf::ipc::json_error("Unknown event kind \"" + kind +
+                "\", expected motion, button or key");
+        }
+
+        params.nr_samples = wf::ipc::json_get_optional_int64(data, "samples").value_or(params.nr_samples);
+        params.timeout    = wf::ipc::json_get_optional_int64(data, "timeout").value_or(params.timeout);
+        params.from.x     = wf::ipc::json_get_optional_double(data, "x0").value_or(params.from.x);
+        params.from.y     = wf::ipc::json_get_optional_double(data, "y0").value_or(params.from.y);
+        params.to.x = wf::ipc::json_get_optional_double(data, "x1").value_or(params.to.x);
+        params.to.y = wf::ipc::json_get_optional_double(data, "y1").value_or(params.to.y);
+        if ((params.nr_samples <= 0) || (params.timeout <= 0))
+        {
+            return wf::ipc::json_error("`samples` and `timeout` must be positive!");
+        }
+
+        latency_benchmark = std::make_unique<latency_benchmark_t>(input.get(), params);
+        return wf::ipc::json_ok();
+    };
+
+    ipc::method_callback get_latency_results = [=] (wf::json_t)
+    {
+        if (!latency_benchmark)
+        {
+            return wf::ipc::json_error("No latency benchmark was started!");
+        }
+
+        return latency_benchmark->get_results();
+    };
+
     std::unique_ptr<headless_input_backend_t> input;
 };
 }
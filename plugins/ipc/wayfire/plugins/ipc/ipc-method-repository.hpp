@@ -3,6 +3,7 @@
 #include <functional>
 #include <map>
 #include "wayfire/signal-provider.hpp"
+#include <wayfire/cost-accounting.hpp>
 #include <wayfire/nonstd/json.hpp>
 #include <string>
 
@@ -67,7 +68,13 @@ class method_repository_t : public wf::signal::provider_t
      */
     void register_method(std::string method, method_callback_full handler)
     {
-        this->methods[method] = handler;
+        // Run the handler on behalf of the plugin which registered it
+        this->methods[method] = [handler, owner = wf::cost::current_owner()] (wf::json_t data,
+                                                                              client_interface_t *client)
+        {
+            wf::cost::scope_t scope{owner, wf::cost::category_t::IPC};
+            return handler(std::move(data), client);
+        };
     }
 
     /**
@@ -76,10 +83,10 @@ class method_repository_t : public wf::signal::provider_t
      */
     void register_method(std::string method, method_callback handler)
     {
-        this->methods[method] = [handler] (const wf::json_t& data, client_interface_t*)
+        register_method(method, [handler] (const wf::json_t& data, client_interface_t*)
         {
             return handler(data);
-        };
+        });
     }
 
     /**
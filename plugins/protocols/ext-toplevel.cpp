@@ -17,14 +17,27 @@
 class wayfire_foreign_toplevel;
 using foreign_toplevel_map_type = std::map<wayfire_toplevel_view, std::unique_ptr<wayfire_foreign_toplevel>>;
 
-void get_state(wayfire_view view, struct wlr_ext_foreign_toplevel_handle_v1_state *state)
+/**
+ * The state of a toplevel handle. wlroots copies the strings, so they only need to live until the state is
+ * passed to it.
+ */
+struct toplevel_state_t
 {
-    std::string title_buffer = view->get_title();
-    std::string appid_buffer = get_app_id(view);
+    std::string title;
+    std::string app_id;
 
-    // Update the state
-    state->title  = strdup(title_buffer.c_str());
-    state->app_id = strdup(appid_buffer.c_str());
+    wlr_ext_foreign_toplevel_handle_v1_state get() const
+    {
+        wlr_ext_foreign_toplevel_handle_v1_state state;
+        state.title  = title.c_str();
+        state.app_id = app_id.c_str();
+        return state;
+    }
+};
+
+toplevel_state_t get_state(wayfire_view view)
+{
+    return toplevel_state_t{view->get_title(), get_app_id(view)};
 }
 
 class wayfire_ext_foreign_toplevel
@@ -63,6 +76,12 @@ class wayfire_ext_foreign_toplevel
     }
 
   protected:
+    /* The state which clients know about */
+    toplevel_state_t sent_state;
+
+    toplevel_update_batcher_t updates{[=] (uint32_t flags) { toplevel_send_state(flags); },
+        "ext-toplevel/title_interval"};
+
     virtual void init_request_handlers()
     {
         // No request handlers at the present moment.
@@ -72,7 +91,8 @@ class wayfire_ext_foreign_toplevel
 
     virtual void send_initial_state()
     {
-        toplevel_send_state();
+        // The initial state is sent by wlroots when the handle is created
+        sent_state = get_state(view);
     }
 
     virtual void init_connections()
@@ -93,25 +113,41 @@ class wayfire_ext_foreign_toplevel
         wlr_ext_foreign_toplevel_handle_v1_destroy(handle);
     }
 
-    virtual void toplevel_send_state()
+    /**
+     * Send the parts of the state given by @flags (see toplevel_update_batcher_t::dirty_flags).
+     */
+    virtual void toplevel_send_state(uint32_t flags)
     {
-        // Prepare the state
-        struct wlr_ext_foreign_toplevel_handle_v1_state new_state;
-        get_state(view, &new_state);
+        auto new_state = sent_state;
+        if (flags & toplevel_update_batcher_t::DIRTY_TITLE)
+        {
+            new_state.title = view->get_title();
+        }
+
+        if (flags & toplevel_update_batcher_t::DIRTY_APP_ID)
+        {
+            new_state.app_id = get_app_id(view);
+        }
+
+        if ((new_state.title == sent_state.title) && (new_state.app_id == sent_state.app_id))
+        {
+            return;
+        }
 
         /** Send the state; done() is sent by wlroots */
-        wlr_ext_foreign_toplevel_handle_v1_update_state(handle,
-            &new_state);
+        sent_state = new_state;
+        auto state = sent_state.get();
+        wlr_ext_foreign_toplevel_handle_v1_update_state(handle, &state);
     }
 
     wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_TITLE);
     };
 
     wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_APP_ID);
     };
 };
 
@@ -149,10 +185,9 @@ class wayfire_ext_foreign_toplevel_protocol_impl : public wf::plugin_interface_t
     {
         if (auto toplevel = wf::toplevel_cast(ev->view))
         {
-            struct wlr_ext_foreign_toplevel_handle_v1_state new_state;
-            get_state(toplevel, &new_state);
-
-            auto handle = wlr_ext_foreign_toplevel_handle_v1_create(toplevel_manager, &new_state);
+            auto state     = get_state(toplevel);
+            auto new_state = state.get();
+            auto handle    = wlr_ext_foreign_toplevel_handle_v1_create(toplevel_manager, &new_state);
             if (!handle)
             {
                 LOGE("Failed to create foreign toplevel handle for view");
@@ -5,6 +5,7 @@
 #include "wayfire/util.hpp"
 #include "wayfire/view.hpp"
 #include <memory>
+#include <algorithm>
 #include <wayfire/plugin.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/toplevel-view.hpp>
@@ -42,7 +43,7 @@ class wayfire_foreign_toplevel
         toplevel_send_title();
         toplevel_send_app_id();
         toplevel_send_state();
-        toplevel_update_output(view->get_output(), true);
+        toplevel_send_output();
 
         view->connect(&on_title_changed);
         view->connect(&on_app_id_changed);
@@ -67,16 +68,55 @@ class wayfire_foreign_toplevel
     }
 
   private:
+    /* The title, app-id and output which clients know about */
+    std::string sent_title;
+    std::string sent_app_id;
+    wf::output_t *sent_output = nullptr;
+
+    toplevel_update_batcher_t updates{[=] (uint32_t flags) { send_updates(flags); },
+        "foreign-toplevel/title_interval"};
+
+    void send_updates(uint32_t flags)
+    {
+        if (flags & toplevel_update_batcher_t::DIRTY_TITLE)
+        {
+            toplevel_send_title();
+        }
+
+        if (flags & toplevel_update_batcher_t::DIRTY_APP_ID)
+        {
+            toplevel_send_app_id();
+        }
+
+        if (flags & toplevel_update_batcher_t::DIRTY_STATE)
+        {
+            toplevel_send_state();
+        }
+
+        if (flags & toplevel_update_batcher_t::DIRTY_OUTPUT)
+        {
+            toplevel_send_output();
+        }
+    }
+
     void toplevel_send_title()
     {
-        wlr_foreign_toplevel_handle_v1_set_title(handle, view->get_title().c_str());
+        auto title = view->get_title();
+        if (title != sent_title)
+        {
+            sent_title = title;
+            wlr_foreign_toplevel_handle_v1_set_title(handle, title.c_str());
+        }
     }
 
     void toplevel_send_app_id()
     {
         std::string app_id = get_app_id(view);
-
-        wlr_foreign_toplevel_handle_v1_set_app_id(handle, app_id.c_str());
+        if (app_id != sent_app_id)
+        {
+            sent_app_id = app_id;
+            wlr_foreign_toplevel_handle_v1_set_app_id(handle, app_id.c_str());
+        }
     }
 
     void toplevel_send_state()
@@ -98,58 +138,67 @@ class wayfire_foreign_toplevel
         }
     }
 
-    void toplevel_update_output(wf::output_t *output, bool enter)
+    void toplevel_send_output()
     {
-        if (output && enter)
+        auto output = view->get_output();
+        if (output == sent_output)
         {
-            wlr_foreign_toplevel_handle_v1_output_enter(handle, output->handle);
+            return;
         }
 
-        if (output && !enter)
+        // wlroots sends output_leave by itself when an output is destroyed
+        auto outputs = wf::get_core().output_layout->get_outputs();
+        if (sent_output && (std::find(outputs.begin(), outputs.end(), sent_output) != outputs.end()))
         {
-            wlr_foreign_toplevel_handle_v1_output_leave(handle, output->handle);
+            wlr_foreign_toplevel_handle_v1_output_leave(handle, sent_output->handle);
+        }
+
+        if (output)
+        {
+            wlr_foreign_toplevel_handle_v1_output_enter(handle, output->handle);
         }
+
+        sent_output = output;
     }
 
     wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto)
     {
-        toplevel_send_title();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_TITLE);
     };
 
     wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed = [=] (auto)
     {
-        toplevel_send_app_id();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_APP_ID);
     };
 
     wf::signal::connection_t<wf::view_set_output_signal> on_set_output = [=] (wf::view_set_output_signal *ev)
     {
-        toplevel_update_output(ev->output, false);
-        toplevel_update_output(view->get_output(), true);
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_OUTPUT);
     };
 
     wf::signal::connection_t<wf::view_minimized_signal> on_minimized = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_STATE);
     };
 
     wf::signal::connection_t<wf::view_fullscreen_signal> on_fullscreen = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_STATE);
     };
 
     wf::signal::connection_t<wf::view_tiled_signal> on_tiled = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_STATE);
     };
 
     wf::signal::connection_t<wf::view_activated_state_signal> on_activated = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_STATE);
     };
 
     wf::signal::connection_t<wf::view_parent_changed_signal> on_parent_changed = [=] (auto)
     {
-        toplevel_send_state();
+        updates.mark_dirty(toplevel_update_batcher_t::DIRTY_STATE);
     };
 
     wf::wl_listener_wrapper toplevel_handle_v1_maximize_request;
@@ -4,6 +4,8 @@
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/toplevel-view.hpp>
 #include "gtk-shell.hpp"
+#include <chrono>
+#include <functional>
 
 std::string get_app_id(wayfire_view view)
 {
@@ -45,3 +47,89 @@ std::string get_app_id(wayfire_view view)
     // Safely copy to the output buffer
     return result;
 }
+
+/**
+ * Batches the updates of a toplevel handle.
+ *
+ * Changes only mark parts of the state as dirty, and everything dirty is sent together once the event loop
+ * goes idle, so that clients get a single done event for many changes. Title changes are additionally sent
+ * at most once per title interval, since some clients change their title very often (e.g. progress in a
+ * terminal).
+ */
+class toplevel_update_batcher_t
+{
+  public:
+    enum dirty_flags
+    {
+        DIRTY_TITLE  = (1 << 0),
+        DIRTY_APP_ID = (1 << 1),
+        DIRTY_STATE  = (1 << 2),
+        DIRTY_OUTPUT = (1 << 3),
+    };
+
+    /**
+     * @param send Sends the parts of the state given by a combination of dirty_flags.
+     * @param title_interval_option The option with the minimal interval between title updates, in
+     *   milliseconds.
+     */
+    toplevel_update_batcher_t(std::function<void(uint32_t)> send, const std::string& title_interval_option) :
+        send(send), title_interval(title_interval_option)
+    {
+        idle_flush.set_callback([=] () { flush(); });
+    }
+
+    void mark_dirty(uint32_t flags)
+    {
+        if (flags & DIRTY_TITLE)
+        {
+            flags &= ~DIRTY_TITLE;
+            auto interval   = std::chrono::milliseconds((int)title_interval);
+            auto since_last = std::chrono::steady_clock::now() - last_title;
+            if (since_last >= interval)
+            {
+                flags |= DIRTY_TITLE;
+            } else if (!title_timer.is_connected())
+            {
+                auto wait = std::chrono::ceil<std::chrono::milliseconds>(interval - since_last);
+                title_timer.set_timeout(wait.count(), [=] ()
+                {
+                    dirty |= DIRTY_TITLE;
+                    idle_flush.run_once();
+                });
+            }
+        }
+
+        dirty |= flags;
+        if (dirty)
+        {
+            idle_flush.run_once();
+        }
+    }
+
+    /** Send all pending changes immediately. */
+    void flush()
+    {
+        idle_flush.disconnect();
+        if (dirty & DIRTY_TITLE)
+        {
+            title_timer.disconnect();
+            last_title = std::chrono::steady_clock::now();
+        }
+
+        uint32_t flags = dirty;
+        dirty = 0;
+        if (flags)
+        {
+            send(flags);
+        }
+    }
+
+  private:
+    std::function<void(uint32_t)> send;
+    wf::option_wrapper_t<int> title_interval;
+
+    uint32_t dirty = 0;
+    std::chrono::steady_clock::time_point last_title;
+    wf::wl_idle_call idle_flush;
+    wf::wl_timer<false> title_timer;
+};
@@ -13,24 +13,30 @@
 #include <memory>
 #include <wayfire/opengl.hpp>
 #include <wayfire/util/log.hpp>
-#include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/async-text.hpp>
 #include <wayfire/scene.hpp>
 #include <wayfire/scene-render.hpp>
 
+/**
+ * Emitted on view_title_texture_t when a new texture has been rendered in the background.
+ */
+struct title_texture_ready_signal
+{};
+
 /**
  * Class storing an overlay with a view's title, only stored for parent views.
  */
-struct view_title_texture_t : public wf::custom_data_t
+struct view_title_texture_t : public wf::custom_data_t, public wf::signal::provider_t
 {
     wayfire_toplevel_view view;
-    wf::cairo_text_t overlay;
+    wf::async_cairo_text_t overlay;
     wf::cairo_text_t::params par;
-    bool overflow = false;
     wayfire_toplevel_view dialog; /* the texture should be rendered on top of this dialog */
 
     /**
      * Render the overlay text in our texture, cropping it to the size by
-     * the given box.
+     * the given box. The text is rendered in the background, until it is
+     * ready, the previous texture (if any) is shown.
      */
     void update_overlay_texture(wf::dimensions_t dim)
     {
@@ -40,8 +46,13 @@ struct view_title_texture_t : public wf::custom_data_t
 
     void update_overlay_texture()
     {
-        auto res = overlay.render_text(view->get_title(), par);
-        overflow = res.width > overlay.get_size().width;
+        overlay.set_text(view->get_title(), par);
+    }
+
+    /* Whether the title had to be cropped to fit */
+    bool overflow() const
+    {
+        return overlay.get_required_size().width > overlay.get_size().width;
     }
 
     wf::signal::connection_t<wf::view_title_changed_signal> view_changed_title =
@@ -59,6 +70,12 @@ struct view_title_texture_t : public wf::custom_data_t
         par.exact_size   = true;
         par.output_scale = output_scale;
 
+        overlay.on_ready = [=] ()
+        {
+            title_texture_ready_signal data;
+            this->emit(&data);
+        };
+
         view->connect(&view_changed_title);
     }
 };
@@ -89,6 +106,11 @@ class title_overlay_node_t : public node_t
     bool overlay_shown = false;
     wf::wl_idle_call idle_update_title;
 
+    wf::signal::connection_t<title_texture_ready_signal> on_title_ready = [=] (title_texture_ready_signal*)
+    {
+        idle_update_title.run_once();
+    };
+
   private:
     /**
      * Gets the overlay texture stored with the given view.
@@ -201,7 +223,7 @@ class title_overlay_node_t : public node_t
         if ((tex.overlay.get_texture().texture == nullptr) ||
             (output_scale != tex.par.output_scale) ||
             (tex.overlay.get_size().width > box.width * output_scale) ||
-            (tex.overflow &&
+            (tex.overflow() &&
              (tex.overlay.get_size().width < std::floor(box.width * output_scale))))
         {
             tex.par.output_scale = output_scale;
@@ -250,6 +272,7 @@ class title_overlay_node_t : public node_t
                 wf::cairo_text_t::measure_height(title.par.font_size, true);
         }
 
+        title.connect(&on_title_ready);
         idle_update_title.set_callback([=] () { update_title(); });
         idle_update_title.run_once();
     }
@@ -7,6 +7,7 @@
 #include <wayfire/plugin.hpp>
 #include <wayfire/output.hpp>
 #include <wayfire/plugins/scale-signal.hpp>
+#include <wayfire/plugins/common/async-text.hpp>
 
 namespace wf
 {
@@ -29,6 +30,9 @@ class scale_show_title_t
     wf::option_wrapper_t<std::string> title_position{"scale/title_position"};
     wf::output_t *output;
 
+    /* Keep the rendered titles cached between activations of scale */
+    wf::shared_data::ref_ptr_t<wf::text_rasterizer_t> title_cache;
+
   public:
     scale_show_title_t();
 
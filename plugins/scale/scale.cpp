@@ -116,6 +116,8 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
     wf::option_wrapper_t<bool> allow_scale_zoom{"scale/allow_zoom"};
     wf::option_wrapper_t<bool> include_minimized{"scale/include_minimized"};
     wf::option_wrapper_t<bool> close_on_new_view{"scale/close_on_new_view"};
+    wf::option_wrapper_t<bool> thumbnail_mipmaps{"scale/thumbnail_mipmaps"};
+    wf::option_wrapper_t<int> inactive_refresh_interval{"scale/inactive_refresh_interval"};
 
     /* maximum scale -- 1.0 means we will not "zoom in" on a view */
     const double max_scale_factor = 1.0;
@@ -720,7 +722,24 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
 
                 view->get_transformed_node()->end_transform_update();
             }
+
+            update_thumbnail_mode(view, view_data);
+        }
+    }
+
+    /* Render views at the resolution they are shown at, and refresh unfocused views less often */
+    void update_thumbnail_mode(wayfire_toplevel_view view, view_scale_data& view_data)
+    {
+        if (!thumbnail_mipmaps)
+        {
+            view_data.transformer->set_thumbnail_mode(std::nullopt);
+            return;
         }
+
+        wf::scene::transformer_base_node_t::thumbnail_mode_t mode;
+        mode.display_scale    = std::max(view_data.transformer->scale_x, view_data.transformer->scale_y);
+        mode.refresh_interval = (view == current_focus_view) ? 0 : (int)inactive_refresh_interval;
+        view_data.transformer->set_thumbnail_mode(mode);
     }
 
     /* Returns a list of views for all workspaces */
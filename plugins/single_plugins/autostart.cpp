@@ -19,6 +19,7 @@ class wayfire_autostart : public wf::plugin_interface_t
 
         bool panel_manually_started = false;
         bool background_manually_started = false;
+        std::vector<std::string> commands;
 
         for (const auto& [name, command] : autostart_entries.value())
         {
@@ -29,7 +30,7 @@ class wayfire_autostart : public wf::plugin_interface_t
                 continue;
             }
 
-            wf::get_core().run(command);
+            commands.push_back(command);
             if (command.find("wf-panel") != std::string::npos)
             {
                 panel_manually_started = true;
@@ -43,13 +44,15 @@ class wayfire_autostart : public wf::plugin_interface_t
 
         if (autostart_wf_shell && !panel_manually_started)
         {
-            wf::get_core().run("wf-panel");
+            commands.push_back("wf-panel");
         }
 
         if (autostart_wf_shell && !background_manually_started)
         {
-            wf::get_core().run("wf-background");
+            commands.push_back("wf-background");
         }
+
+        wf::get_core().run_batch(commands);
     }
 
     bool is_unloadable() override
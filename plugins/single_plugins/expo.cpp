@@ -43,6 +43,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     wf::option_wrapper_t<bool> keyboard_interaction{"expo/keyboard_interaction"};
     wf::option_wrapper_t<double> inactive_brightness{"expo/inactive_brightness"};
     wf::option_wrapper_t<int> transition_length{"expo/transition_length"};
+    wf::option_wrapper_t<int> thumbnail_cache_timeout{"expo/thumbnail_cache_timeout"};
     wf::geometry_animation_t zoom_animation{zoom_duration};
 
     wf::option_wrapper_t<bool> move_enable_snap_off{"move/enable_snap_off"};
@@ -310,6 +311,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     {
         wall->set_background_color(background_color);
         wall->set_gap_size(this->delimiter_offset);
+        wall->set_cache_timeout(thumbnail_cache_timeout);
         if (zoom_in)
         {
             zoom_animation.set_start(wall->get_workspace_rectangle(
@@ -87,7 +87,7 @@ class wayfire_invert_screen : public wf::per_output_plugin_instance_t
                 output->render->rem_post(&hook);
             } else
             {
-                output->render->add_post(&hook);
+                output->render->add_post(&hook, wf::post_hook_footprint_t::per_pixel());
             }
 
             active = !active;
@@ -131,7 +131,14 @@ class wayfire_invert_screen : public wf::per_output_plugin_instance_t
             program.uniform1i("preserve_hue", preserve_hue);
 
             GL_CALL(glDisable(GL_BLEND));
-            GL_CALL(glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+            GL_CALL(glEnable(GL_SCISSOR_TEST));
+            for (const auto& box : output->render->get_post_damage())
+            {
+                wf::gles::scissor_render_buffer(destination, wlr_box_from_pixman_box(box));
+                GL_CALL(glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+            }
+
+            GL_CALL(glDisable(GL_SCISSOR_TEST));
             GL_CALL(glEnable(GL_BLEND));
             GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
 
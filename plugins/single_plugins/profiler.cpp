@@ -0,0 +1,218 @@
+#include "wayfire/object.hpp"
+#include "wayfire/option-wrapper.hpp"
+#include "wayfire/scene-operations.hpp"
+#include "wayfire/signal-provider.hpp"
+#include "wayfire/util.hpp"
+#include "wayfire/plugins/ipc/ipc-helpers.hpp"
+#include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include "wayfire/plugins/common/cairo-util.hpp"
+#include "wayfire/plugins/common/shared-core-data.hpp"
+#include "wayfire/plugins/common/simple-text-node.hpp"
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/cost-accounting.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/plugin.hpp>
+#include <wayfire/output-layout.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * Reports how much CPU and GPU time the compositor spends on behalf of each plugin, either over IPC or in an
+ * overlay on every output.
+ *
+ * GPU time is measured per render pass: the main pass of each output always counts as "core", plugins are
+ * charged only for the passes they run on their own buffers.
+ */
+class wayfire_profiler_plugin_t : public wf::plugin_interface_t
+{
+  public:
+    void init() override
+    {
+        method_repository->register_method("profiler/start", start);
+        method_repository->register_method("profiler/stop", stop);
+        method_repository->register_method("profiler/stats", stats);
+
+        overlay.set_callback([=] () { update_overlay(); });
+        update_interval.set_callback([=] () { update_overlay(); });
+        wf::get_core().output_layout->connect(&on_new_output);
+        update_overlay();
+    }
+
+    void fini() override
+    {
+        method_repository->unregister_method("profiler/start");
+        method_repository->unregister_method("profiler/stop");
+        method_repository->unregister_method("profiler/stats");
+
+        remove_overlays();
+        wf::cost::set_enabled(false);
+    }
+
+  private:
+    wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> method_repository;
+    wf::option_wrapper_t<bool> overlay{"profiler/overlay"};
+    wf::option_wrapper_t<int> update_interval{"profiler/update_interval"};
+
+    /* Whether accounting was started over IPC */
+    bool started_by_ipc = false;
+    wf::wl_timer<true> refresh_timer;
+
+    struct output_overlay_data_t : public wf::custom_data_t
+    {
+        std::shared_ptr<simple_text_node_t> node;
+        ~output_overlay_data_t()
+        {
+            wf::scene::damage_node(node, node->get_bounding_box());
+            wf::scene::remove_child(node);
+        }
+    };
+
+    /** The stats of all owners which have spent any time, the most expensive ones first. */
+    static std::vector<wf::cost::owner_stats_t> get_sorted_stats()
+    {
+        const auto& total = [] (const wf::cost::owner_stats_t& stats)
+        {
+            auto sum = stats.gpu;
+            for (auto& cpu : stats.cpu)
+            {
+                sum += cpu;
+            }
+
+            return sum;
+        };
+
+        auto stats = wf::cost::get_stats();
+        stats.erase(std::remove_if(stats.begin(), stats.end(),
+            [&] (const auto& owner) { return total(owner).count() == 0; }), stats.end());
+        std::sort(stats.begin(), stats.end(),
+            [&] (const auto& a, const auto& b) { return total(a) > total(b); });
+        return stats;
+    }
+
+    wf::ipc::method_callback start = [=] (wf::json_t)
+    {
+        started_by_ipc = true;
+        wf::cost::set_enabled(true);
+        return wf::ipc::json_ok();
+    };
+
+    wf::ipc::method_callback stop = [=] (wf::json_t)
+    {
+        started_by_ipc = false;
+        wf::cost::set_enabled(overlay);
+        return wf::ipc::json_ok();
+    };
+
+    wf::ipc::method_callback stats = [=] (wf::json_t)
+    {
+        auto response = wf::ipc::json_ok();
+        response["enabled"] = wf::cost::enabled;
+        response["plugins"] = wf::json_t::array();
+        for (auto& owner : get_sorted_stats())
+        {
+            wf::json_t entry;
+            entry["name"] = owner.name;
+            for (int c = 0; c < (int)wf::cost::category_t::TOTAL; c++)
+            {
+                entry["cpu"][wf::cost::get_category_name((wf::cost::category_t)c)] =
+                    (int64_t)owner.cpu[c].count();
+            }
+
+            entry["gpu"] = (int64_t)owner.gpu.count();
+            response["plugins"].append(entry);
+        }
+
+        return response;
+    };
+
+    std::string format_overlay_text()
+    {
+        const auto& ms = [] (std::chrono::nanoseconds time)
+        {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << time.count() / 1'000'000.0;
+            return out.str();
+        };
+
+        std::ostringstream text;
+        text << "ms/s: cpu / gpu";
+        for (auto& owner : get_sorted_stats())
+        {
+            std::chrono::nanoseconds cpu{0};
+            for (auto& time : owner.cpu)
+            {
+                cpu += time;
+            }
+
+            text << "\n" << owner.name << ": " << ms(cpu) << " / " << ms(owner.gpu);
+        }
+
+        return text.str();
+    }
+
+    void show_overlay(wf::output_t *wo, const std::string& text)
+    {
+        auto data = wo->get_data_safe<output_overlay_data_t>();
+        if (!data->node)
+        {
+            data->node = std::make_shared<simple_text_node_t>();
+            data->node->set_text_params(wf::cairo_text_t::params(14 /* font_size */,
+                wf::color_t{0.1, 0.1, 0.1, 0.8} /* bg_color */,
+                wf::color_t{0.9, 0.9, 0.9, 1} /* fg_color */));
+            wf::scene::readd_front(wo->node_for_layer(wf::scene::layer::DWIDGET), data->node);
+        }
+
+        auto og = wo->get_relative_geometry();
+        auto size = data->node->get_bounding_box();
+        data->node->set_position({og.width - size.width - 10, 10});
+        data->node->set_text(text);
+    }
+
+    void remove_overlays()
+    {
+        refresh_timer.disconnect();
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            wo->erase_data<output_overlay_data_t>();
+        }
+    }
+
+    void refresh_overlays()
+    {
+        auto text = format_overlay_text();
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            show_overlay(wo, text);
+        }
+    }
+
+    void update_overlay()
+    {
+        wf::cost::set_enabled(overlay || started_by_ipc);
+        if (!overlay)
+        {
+            remove_overlays();
+            return;
+        }
+
+        refresh_overlays();
+        refresh_timer.disconnect();
+        refresh_timer.set_timeout(std::max(100, (int)update_interval), [=] ()
+        {
+            refresh_overlays();
+            return true;
+        });
+    }
+
+    wf::signal::connection_t<wf::output_added_signal> on_new_output = [=] (wf::output_added_signal *ev)
+    {
+        if (overlay)
+        {
+            show_overlay(ev->output, format_overlay_text());
+        }
+    };
+};
+
+DECLARE_WAYFIRE_PLUGIN(wayfire_profiler_plugin_t);
@@ -1,5 +1,6 @@
 #include "wayfire/geometry.hpp"
 #include "wayfire/plugins/common/input-grab.hpp"
+#include "wayfire/plugins/common/util.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/txn/transaction-manager.hpp"
 #include <wayfire/toplevel.hpp>
@@ -13,7 +14,10 @@
 #include <wayfire/signal-definitions.hpp>
 #include <wayfire/plugins/wobbly/wobbly-signal.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
+#include <wayfire/view-transform.hpp>
+#include <wayfire/util.hpp>
 #include <wlr/util/edges.h>
+#include <algorithm>
 
 class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::pointer_interaction_t,
     public wf::touch_interaction_t
@@ -45,11 +49,25 @@ class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::point
     {
         if (ev->view == view)
         {
+            stop_pacing();
             view = nullptr;
             input_pressed(WLR_BUTTON_RELEASED);
         }
     };
 
+    wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
+        [=] (wf::view_geometry_changed_signal *ev)
+    {
+        // The client has caught up with (some) configure, so we can send the latest size.
+        if (paced_geometry && !view->toplevel()->is_configure_pending())
+        {
+            send_geometry(*paced_geometry);
+        } else
+        {
+            update_preview();
+        }
+    };
+
     wf::button_callback activate_binding;
     wf::button_callback activate_binding_preserve_aspect;
 
@@ -67,6 +85,18 @@ class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::point
     wf::option_wrapper_t<wf::buttonbinding_t> button{"resize/activate"};
     wf::option_wrapper_t<wf::buttonbinding_t> button_preserve_aspect{
         "resize/activate_preserve_aspect"};
+    wf::option_wrapper_t<bool> configure_pacing{"resize/configure_pacing"};
+    wf::option_wrapper_t<int> max_configure_delay{"resize/max_configure_delay"};
+
+    /**
+     * With configure pacing, a new size is sent to the client only after it has responded to the previous
+     * one, or after max_configure_delay. In the meantime, the latest requested geometry is stored here and
+     * a scaled preview of the last buffer is shown instead.
+     */
+    std::optional<wf::geometry_t> paced_geometry;
+    int64_t last_configure_time = 0;
+    wf::wl_timer<false> pacing_timer;
+    const std::string preview_transformer = "resize-preview";
     std::unique_ptr<wf::input_grab_t> input_grab;
     wf::plugin_activation_data_t grab_interface = {
         .name = "resize",
@@ -232,6 +262,7 @@ class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::point
         }
 
         this->view = view;
+        view->connect(&on_view_geometry_changed);
 
         auto og = view->get_bounding_box();
         int anchor_x = og.x;
@@ -265,6 +296,12 @@ class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::point
 
         if (view)
         {
+            if (paced_geometry)
+            {
+                send_geometry(*paced_geometry);
+            }
+
+            stop_pacing();
             end_wobbly(view);
 
             wf::view_change_workspace_signal workspace_may_changed;
@@ -442,11 +479,100 @@ class wayfire_resize : public wf::per_output_plugin_instance_t, public wf::point
             desired.y += desired_unconstrained.height - desired.height;
         }
 
-        if (wf::dimensions(view->toplevel()->pending().geometry) != wf::dimensions(desired))
+        auto last_requested = paced_geometry.value_or(view->toplevel()->pending().geometry);
+        if (wf::dimensions(last_requested) != wf::dimensions(desired))
+        {
+            request_geometry(desired);
+        }
+    }
+
+    /**
+     * How long to wait for the client to respond to a configure before sending the next one anyway: twice
+     * the client's usual response time, so that a single slow frame does not stall the resize, but at most
+     * max_configure_delay.
+     */
+    int64_t get_pacing_interval()
+    {
+        const int latency = view->toplevel()->get_configure_latency();
+        if (latency <= 0)
+        {
+            return max_configure_delay;
+        }
+
+        return std::clamp<int64_t>(2 * latency, 1, std::max(1, (int)max_configure_delay));
+    }
+
+    void request_geometry(wf::geometry_t desired)
+    {
+        const int64_t since_last_configure = wf::get_current_time() - last_configure_time;
+        const int64_t interval = get_pacing_interval();
+        if (!configure_pacing || !view->toplevel()->is_configure_pending() ||
+            (since_last_configure >= interval))
+        {
+            send_geometry(desired);
+            return;
+        }
+
+        // The client is still busy with the last size. Wait until it responds or the interval passes.
+        paced_geometry = desired;
+        if (!pacing_timer.is_connected())
+        {
+            pacing_timer.set_timeout(std::max<int64_t>(1, interval - since_last_configure), [=] ()
+            {
+                if (view && paced_geometry)
+                {
+                    send_geometry(*paced_geometry);
+                }
+            });
+        }
+
+        update_preview();
+    }
+
+    void send_geometry(wf::geometry_t desired)
+    {
+        paced_geometry.reset();
+        pacing_timer.disconnect();
+        last_configure_time = wf::get_current_time();
+
+        view->toplevel()->pending().gravity  = calculate_gravity();
+        view->toplevel()->pending().geometry = desired;
+        wf::get_core().tx_manager->schedule_object(view->toplevel());
+        update_preview();
+    }
+
+    /**
+     * Stretch the last buffer of the view to the last requested geometry while the client is catching up.
+     */
+    void update_preview()
+    {
+        auto tmgr    = view->get_transformed_node();
+        auto current = view->get_geometry();
+        auto target  = paced_geometry.value_or(view->toplevel()->pending().geometry);
+        if (!configure_pacing || (current == target) || (current.width <= 0) || (current.height <= 0))
+        {
+            tmgr->rem_transformer(preview_transformer);
+            return;
+        }
+
+        auto tr = wf::ensure_named_transformer<wf::scene::view_2d_transformer_t>(
+            view, wf::TRANSFORMER_2D, preview_transformer, view);
+        tmgr->begin_transform_update();
+        tr->scale_x = 1.0 * target.width / current.width;
+        tr->scale_y = 1.0 * target.height / current.height;
+        tr->translation_x = (target.x + target.width / 2.0) - (current.x + current.width / 2.0);
+        tr->translation_y = (target.y + target.height / 2.0) - (current.y + current.height / 2.0);
+        tmgr->end_transform_update();
+    }
+
+    void stop_pacing()
+    {
+        paced_geometry.reset();
+        pacing_timer.disconnect();
+        on_view_geometry_changed.disconnect();
+        if (view)
         {
-            view->toplevel()->pending().gravity  = calculate_gravity();
-            view->toplevel()->pending().geometry = desired;
-            wf::get_core().tx_manager->schedule_object(view->toplevel());
+            view->get_transformed_node()->rem_transformer(preview_transformer);
         }
     }
 
@@ -103,6 +103,8 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::option_wrapper_t<wf::animation_description_t> speed{"switcher/speed"};
     wf::option_wrapper_t<int> view_thumbnail_rotation{
         "switcher/view_thumbnail_rotation"};
+    wf::option_wrapper_t<int> inactive_refresh_interval{
+        "switcher/inactive_refresh_interval"};
 
     duration_t duration{speed};
     duration_t background_dim_duration{speed};
@@ -703,6 +705,14 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             (float)sv.attribs.rotation, {0.0, 1.0, 0.0});
 
         transform->color[3] = sv.attribs.alpha;
+
+        // Views are shown scaled down, so render them at a matching resolution.
+        wf::scene::transformer_base_node_t::thumbnail_mode_t mode;
+        mode.display_scale    = std::max((double)sv.attribs.scale_x, (double)sv.attribs.scale_y);
+        mode.refresh_interval =
+            (sv.position == SWITCHER_POSITION_CENTER) ? 0 : (int)inactive_refresh_interval;
+        transform->set_thumbnail_mode(mode);
+
         render_view_scene(sv.view, buffer);
     }
 
@@ -20,7 +20,7 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
             return;
         }
 
-        output->render->add_post(&render_hook);
+        output->render->add_post(&render_hook, wf::post_hook_footprint_t::per_pixel());
 
         vk_renderer = wlr_vk_renderer_create_with_drm_fd(wlr_renderer_get_drm_fd(wf::get_core().renderer));
     }
@@ -28,7 +28,15 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
     wf::post_hook_t render_hook = [=] (wf::auxilliary_buffer_t& source,
                                        const wf::render_buffer_t& destination)
     {
-        GL_CALL(glFinish());
+        // Let the Vulkan renderer wait for the scene pass on the GPU. Without a fence (renderer without
+        // timeline support), we have to wait for the GL commands to finish on the CPU instead.
+        const auto& fence = source.get_ready_fence();
+        const bool gpu_wait = fence.has_sync_point() && vk_renderer->features.timeline;
+        if (!gpu_wait)
+        {
+            GL_CALL(glFinish());
+        }
+
         wlr_dmabuf_attributes dmabuf{};
 
         if (!wlr_buffer_get_dmabuf(source.get_buffer(), &dmabuf))
@@ -63,7 +71,14 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
         tex.filter_mode = WLR_SCALE_FILTER_BILINEAR; // Use bilinear filtering for a smooth copy
         tex.transform   = WL_OUTPUT_TRANSFORM_NORMAL;
         tex.alpha = NULL;
-        tex.clip  = NULL;
+        if (gpu_wait)
+        {
+            tex.wait_timeline = fence.get_timeline();
+            tex.wait_point    = fence.get_point();
+        }
+
+        wf::region_t damage = output->render->get_post_damage();
+        tex.clip = damage.to_pixman();
         wlr_render_pass_add_texture(pass, &tex);
         wlr_render_pass_submit(pass);
         wlr_texture_destroy(vk_tex);
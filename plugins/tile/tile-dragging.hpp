@@ -122,7 +122,7 @@ class drag_manager_t
             preview = std::make_shared<wf::preview_indication_t>(start_coords, output, "simple-tile");
         }
 
-        auto preview_geometry = calculate_split_preview(view, split);
+        auto preview_geometry = calculate_split_preview(view, split, dragged_view);
         preview_geometry = get_wset_local_coordinates(output->wset(), preview_geometry);
         if (preview_geometry != preview->get_target_geometry())
         {
@@ -171,7 +171,7 @@ class drag_manager_t
         }
 
         {
-            autocommit_transaction_t tx;
+            layout_batch_t batch;
 
             auto old_tile_a = view_node_t::get_node(a);
             auto old_tile_b = view_node_t::get_node(b);
@@ -187,11 +187,11 @@ class drag_manager_t
 
             auto new_b = std::make_unique<tile::view_node_t>(b);
             new_b->set_gaps(gaps_a);
-            new_b->set_geometry(geometry_a, tx.tx);
+            new_b->set_geometry(geometry_a, batch);
 
             auto new_a = std::make_unique<tile::view_node_t>(a);
             new_a->set_gaps(gaps_b);
-            new_a->set_geometry(geometry_b, tx.tx);
+            new_a->set_geometry(geometry_b, batch);
 
             new_a->parent = parent_b;
             new_b->parent = parent_a;
@@ -216,27 +216,20 @@ class drag_manager_t
         }
     }
 
-    void handle_move_retile(wayfire_toplevel_view source, nonstd::observer_ptr<tile::view_node_t> target,
-        split_insertion_t split)
+    /**
+     * Move the node of the dragged view next to the node it was dropped on. This is used both for the actual
+     * drop, and on a copy of the tree for the preview.
+     */
+    static void retile_node(nonstd::observer_ptr<view_node_t> source_node,
+        nonstd::observer_ptr<view_node_t> target, split_insertion_t split, layout_batch_t& batch)
     {
-        auto source_output = source->get_output();
-        auto target_output = target->view->get_output();
-
-        if (source_output != target_output)
-        {
-            wf::emit_view_pre_moved_to_wset_pre(source, source->get_wset(), target->view->get_wset());
-            move_tiled_view(source, target_output);
-        }
-
-        autocommit_transaction_t tx;
         auto split_type = (split == INSERT_LEFT || split == INSERT_RIGHT) ?
             SPLIT_VERTICAL : SPLIT_HORIZONTAL;
 
-        auto source_node = view_node_t::get_node(source);
         if (target->parent->get_split_direction() == split_type)
         {
             /* We can simply add the dragged view as a sibling of the target view */
-            auto src = source_node->parent->remove_child(source_node, tx.tx);
+            auto src = source_node->parent->remove_child(source_node, batch);
 
             int idx = find_idx(target);
             if ((split == INSERT_RIGHT) || (split == INSERT_BELOW))
@@ -244,7 +237,7 @@ class drag_manager_t
                 ++idx;
             }
 
-            target->parent->add_child(std::move(src), tx.tx, idx);
+            target->parent->add_child(std::move(src), batch, idx);
         } else
         {
             /* Case 2: we need a new split just for the dropped on and the dragged
@@ -252,32 +245,47 @@ class drag_manager_t
             auto new_split = std::make_unique<split_node_t>(split_type);
             /* The size will be autodetermined by the tree structure, but we set
              * some valid size here to avoid UB */
-            new_split->set_geometry(target->geometry, tx.tx);
+            new_split->set_geometry(target->geometry, batch);
 
             /* Find the position of the dropped view and its parent */
             int idx = find_idx(target);
             auto dropped_parent = target->parent;
 
             /* Remove both views */
-            auto dropped_view = target->parent->remove_child(target, tx.tx);
-            auto dragged_view = source_node->parent->remove_child(source_node, tx.tx);
+            auto dropped_view = target->parent->remove_child(target, batch);
+            auto dragged_view = source_node->parent->remove_child(source_node, batch);
 
             if ((split == INSERT_ABOVE) || (split == INSERT_LEFT))
             {
-                new_split->add_child(std::move(dragged_view), tx.tx);
-                new_split->add_child(std::move(dropped_view), tx.tx);
+                new_split->add_child(std::move(dragged_view), batch);
+                new_split->add_child(std::move(dropped_view), batch);
             } else
             {
-                new_split->add_child(std::move(dropped_view), tx.tx);
-                new_split->add_child(std::move(dragged_view), tx.tx);
+                new_split->add_child(std::move(dropped_view), batch);
+                new_split->add_child(std::move(dragged_view), batch);
             }
 
             /* Put them in place */
-            dropped_parent->add_child(std::move(new_split), tx.tx, idx);
+            dropped_parent->add_child(std::move(new_split), batch, idx);
+        }
+    }
+
+    void handle_move_retile(wayfire_toplevel_view source, nonstd::observer_ptr<tile::view_node_t> target,
+        split_insertion_t split)
+    {
+        auto source_output = source->get_output();
+        auto target_output = target->view->get_output();
+
+        if (source_output != target_output)
+        {
+            wf::emit_view_pre_moved_to_wset_pre(source, source->get_wset(), target->view->get_wset());
+            move_tiled_view(source, target_output);
         }
 
-        tile_workspace_set_data_t::get(source_output).refresh(tx.tx);
-        tile_workspace_set_data_t::get(target_output).refresh(tx.tx);
+        layout_batch_t batch;
+        retile_node(view_node_t::get_node(source), target, split, batch);
+        tile_workspace_set_data_t::get(source_output).refresh(batch);
+        tile_workspace_set_data_t::get(target_output).refresh(batch);
 
         if (source_output != target_output)
         {
@@ -374,36 +382,57 @@ class drag_manager_t
         return calculate_insert_type(node, input, SPLIT_PREVIEW_PERCENTAGE);
     }
 
-    /**
-     * Calculate the bounds of the split preview
-     */
-    wf::geometry_t calculate_split_preview(nonstd::observer_ptr<tree_node_t> over,
-        split_insertion_t split_type)
+    static nonstd::observer_ptr<view_node_t> find_view_node(nonstd::observer_ptr<tree_node_t> root,
+        wayfire_toplevel_view view)
     {
-        auto preview = over->geometry;
-        switch (split_type)
+        if (auto view_node = root->as_view_node())
         {
-          case INSERT_RIGHT:
-            preview.x += preview.width * (1 - SPLIT_PREVIEW_PERCENTAGE);
+            return (view_node->view == view) ? view_node : nullptr;
+        }
 
-          // fallthrough
-          case INSERT_LEFT:
-            preview.width = preview.width * SPLIT_PREVIEW_PERCENTAGE;
-            break;
+        for (auto& child : root->children)
+        {
+            if (auto found = find_view_node({child}, view))
+            {
+                return found;
+            }
+        }
+
+        return nullptr;
+    }
 
-          case INSERT_BELOW:
-            preview.y += preview.height * (1 - SPLIT_PREVIEW_PERCENTAGE);
+    /**
+     * Calculate the bounds of the split preview, i.e. the geometry which the dragged view gets if it is
+     * dropped. To find it, the drop is done on a copy of the tree, which is laid out in a dry-run batch.
+     */
+    wf::geometry_t calculate_split_preview(nonstd::observer_ptr<view_node_t> over,
+        split_insertion_t split_type, wayfire_toplevel_view dragged_view)
+    {
+        if ((split_type == INSERT_NONE) || (split_type == INSERT_SWAP))
+        {
+            return over->geometry;
+        }
 
-          // fallthrough
-          case INSERT_ABOVE:
-            preview.height = preview.height * SPLIT_PREVIEW_PERCENTAGE;
-            break;
+        layout_batch_t dry_run{true};
+        auto root = get_root(over);
+        auto copy = clone_tree(root);
 
-          default:
-            break; // nothing to do
+        /* A view dragged from another tree is dropped from a temporary parent */
+        split_node_t other_tree{SPLIT_VERTICAL};
+        auto source = find_view_node(copy, dragged_view);
+        if (!source)
+        {
+            other_tree.add_child(std::make_unique<view_node_t>(dragged_view, false), dry_run);
+            source = other_tree.children.front()->as_view_node();
         }
 
-        return preview;
+        retile_node(source, find_view_node(copy, over->view), split_type, dry_run);
+        flatten_tree(copy);
+        copy->set_gaps(root->get_gaps());
+        copy->set_geometry(root->geometry, dry_run);
+
+        auto dropped = find_view_node(copy, dragged_view);
+        return dropped ? dropped->geometry : over->geometry;
     }
 
     /**
@@ -314,6 +314,9 @@ inline wf::json_t handle_ipc_set_layout(json_t params)
         return wf::ipc::json_error(*err);
     }
 
+    // All views are resized in one transaction, once the new layout is in place
+    tile::layout_batch_t batch;
+
     // Step 1: detach any views which are currently present in the layout, but should no longer be
     // in the layout
     std::vector<nonstd::observer_ptr<tile::view_node_t>> views_to_remove;
@@ -327,43 +330,40 @@ inline wf::json_t handle_ipc_set_layout(json_t params)
 
     tile_ws.detach_views(views_to_remove);
 
+    data.touched_wsets.erase(nullptr);
+
+    // Step 2: temporarily detach some of the nodes
+    for (auto& touched_view : data.touched_views)
     {
-        autocommit_transaction_t tx;
-        data.touched_wsets.erase(nullptr);
+        auto tile = wf::tile::view_node_t::get_node(touched_view);
+        if (tile)
+        {
+            tile->parent->remove_child(tile, batch);
+        }
 
-        // Step 2: temporarily detach some of the nodes
-        for (auto& touched_view : data.touched_views)
+        if (touched_view->get_wset().get() != ws)
         {
-            auto tile = wf::tile::view_node_t::get_node(touched_view);
-            if (tile)
-            {
-                tile->parent->remove_child(tile, tx.tx);
-            }
+            auto old_wset = touched_view->get_wset();
+            wf::emit_view_pre_moved_to_wset_pre(touched_view,
+                touched_view->get_wset(), ws->shared_from_this());
 
-            if (touched_view->get_wset().get() != ws)
+            if (old_wset)
             {
-                auto old_wset = touched_view->get_wset();
-                wf::emit_view_pre_moved_to_wset_pre(touched_view,
-                    touched_view->get_wset(), ws->shared_from_this());
-
-                if (old_wset)
-                {
-                    old_wset->remove_view(touched_view);
-                }
-
-                ws->add_view(touched_view);
-                wf::emit_view_moved_to_wset(touched_view, old_wset, ws->shared_from_this());
+                old_wset->remove_view(touched_view);
             }
-        }
 
-        // Step 3: set up the new layout
-        tile_ws.roots[x][y] = build_tree_from_json(params["layout"], &tile_ws, {static_cast<int>(x),
-            static_cast<int>(y)});
-        tile::flatten_tree(tile_ws.roots[x][y]);
-        tile_ws.roots[x][y]->set_gaps(tile_ws.get_gaps());
-        tile_ws.roots[x][y]->set_geometry(workarea, tx.tx);
+            ws->add_view(touched_view);
+            wf::emit_view_moved_to_wset(touched_view, old_wset, ws->shared_from_this());
+        }
     }
 
+    // Step 3: set up the new layout
+    tile_ws.roots[x][y] = build_tree_from_json(params["layout"], &tile_ws, {static_cast<int>(x),
+        static_cast<int>(y)});
+    tile::flatten_tree(tile_ws.roots[x][y]);
+    tile_ws.roots[x][y]->set_gaps(tile_ws.get_gaps());
+    tile_ws.roots[x][y]->set_geometry(workarea, batch);
+
     data.touched_wsets.insert(ws);
 
     // Step 4: flatten roots, set gaps, trigger resize everywhere
@@ -17,6 +17,7 @@
 #include "wayfire/object.hpp"
 #include "wayfire/option-wrapper.hpp"
 #include "wayfire/plugin.hpp"
+#include "wayfire/plugins/common/animation-scheduler.hpp"
 #include "wayfire/plugins/common/input-grab.hpp"
 #include "wayfire/plugins/common/shared-core-data.hpp"
 #include "wayfire/scene-input.hpp"
@@ -199,6 +200,7 @@ class tile_output_plugin_t : public wf::pointer_interaction_t, public wf::custom
         auto existing_node = wf::tile::view_node_t::get_node(view);
         if (existing_node)
         {
+            tile::layout_batch_t batch;
             detach_view(view);
             attach_view(view, vp);
         }
@@ -308,13 +310,13 @@ class tile_output_plugin_t : public wf::pointer_interaction_t, public wf::custom
 
             if (was_maximized)
             {
-                autocommit_transaction_t tx;
+                tile::layout_batch_t batch;
 
                 current_node->show_maximized = false;
-                current_node->set_geometry(current_node->geometry, tx.tx);
+                current_node->set_geometry(current_node->geometry, batch);
 
                 adjacent->show_maximized = true;
-                adjacent->set_geometry(adjacent->geometry, tx.tx);
+                adjacent->set_geometry(adjacent->geometry, batch);
             }
 
             /* This will lower the fullscreen status of the view */
@@ -448,6 +450,7 @@ class tile_plugin_t : public wf::plugin_interface_t, wf::per_output_tracker_mixi
     {
         preview_manager.reset();
         fini_output_tracking();
+        tile::stop_view_animations();
         for (auto wset : workspace_set_t::get_all())
         {
             wset->erase_data<tile_workspace_set_data_t>();
@@ -456,6 +459,7 @@ class tile_plugin_t : public wf::plugin_interface_t, wf::per_output_tracker_mixi
         for (auto wo : wf::get_core().output_layout->get_outputs())
         {
             wo->erase_data<tile_output_plugin_t>();
+            wf::animation_scheduler_t::release(wo);
         }
 
         ipc_repo->unregister_method("simple-tile/get-layout");
@@ -541,6 +545,7 @@ class tile_plugin_t : public wf::plugin_interface_t, wf::per_output_tracker_mixi
     void handle_new_output(wf::output_t *output) override
     {
         output->store_data(std::make_unique<tile_output_plugin_t>(output));
+        wf::animation_scheduler_t::acquire(output);
     }
 
     void handle_output_removed(wf::output_t *output) override
@@ -3,29 +3,10 @@
 #include "tree.hpp"
 #include "tree-controller.hpp"
 #include "wayfire/view-helpers.hpp"
-#include "wayfire/txn/transaction-manager.hpp"
 #include "wayfire/scene-operations.hpp"
 #include <wayfire/workarea.hpp>
 #include <wayfire/window-manager.hpp>
 
-struct autocommit_transaction_t
-{
-  public:
-    wf::txn::transaction_uptr tx;
-    autocommit_transaction_t()
-    {
-        tx = wf::txn::transaction_t::create();
-    }
-
-    ~autocommit_transaction_t()
-    {
-        if (!tx->get_objects().empty())
-        {
-            wf::get_core().tx_manager->schedule_transaction(std::move(tx));
-        }
-    }
-};
-
 namespace wf
 {
 /**
@@ -141,6 +122,7 @@ class tile_workspace_set_data_t : public wf::custom_data_t
         wf::geometry_t output_geometry =
             wset.lock()->get_last_output_geometry().value_or(tile::default_output_resolution);
 
+        tile::layout_batch_t batch;
         auto wsize = wset.lock()->get_workspace_grid_size();
         for (int i = 0; i < wsize.width; i++)
         {
@@ -150,9 +132,7 @@ class tile_workspace_set_data_t : public wf::custom_data_t
                 auto vp_geometry = workarea;
                 vp_geometry.x += i * output_geometry.width;
                 vp_geometry.y += j * output_geometry.height;
-
-                autocommit_transaction_t tx;
-                roots[i][j]->set_geometry(vp_geometry, tx.tx);
+                roots[i][j]->set_geometry(vp_geometry, batch);
             }
         }
     }
@@ -181,28 +161,28 @@ class tile_workspace_set_data_t : public wf::custom_data_t
         };
     }
 
-    void update_gaps_with_tx(wf::txn::transaction_uptr& tx)
+    void update_gaps_with_batch(tile::layout_batch_t& batch)
     {
         for (auto& col : roots)
         {
             for (auto& root : col)
             {
                 root->set_gaps(get_gaps());
-                root->set_geometry(root->geometry, tx);
+                root->set_geometry(root->geometry, batch);
             }
         }
     }
 
-    void refresh(wf::txn::transaction_uptr& tx)
+    void refresh(tile::layout_batch_t& batch)
     {
         flatten_roots();
-        update_gaps_with_tx(tx);
+        update_gaps_with_batch(batch);
     }
 
     std::function<void()> update_gaps = [=] ()
     {
-        autocommit_transaction_t tx;
-        update_gaps_with_tx(tx.tx);
+        tile::layout_batch_t batch;
+        update_gaps_with_batch(batch);
     };
 
     void flatten_roots()
@@ -260,12 +240,11 @@ class tile_workspace_set_data_t : public wf::custom_data_t
 
     void attach_view(wayfire_toplevel_view view, std::optional<wf::point_t> _vp = {})
     {
+        /* Leaving fullscreen and unmaximizing other views resize them too, do it all in one transaction */
+        tile::layout_batch_t batch;
         auto vp = _vp.value_or(wset.lock()->get_current_workspace());
         auto view_node = setup_view_tiling(view, vp);
-        {
-            autocommit_transaction_t tx;
-            roots[vp.x][vp.y]->as_split_node()->add_child(std::move(view_node), tx.tx);
-        }
+        roots[vp.x][vp.y]->as_split_node()->add_child(std::move(view_node), batch);
 
         consider_exit_fullscreen(view);
         unmaximize_all_views_on_workspace();
@@ -275,24 +254,22 @@ class tile_workspace_set_data_t : public wf::custom_data_t
     void detach_views(std::vector<nonstd::observer_ptr<tile::view_node_t>> views,
         bool reinsert = true)
     {
+        tile::layout_batch_t batch;
+        for (auto& v : views)
         {
-            autocommit_transaction_t tx;
-            for (auto& v : views)
-            {
-                auto view = v->view;
-                view->set_allowed_actions(VIEW_ALLOW_ALL);
-                // After this, `v` is freed.
-                v->parent->remove_child(v, tx.tx);
+            auto view = v->view;
+            view->set_allowed_actions(VIEW_ALLOW_ALL);
+            // After this, `v` is freed.
+            v->parent->remove_child(v, batch);
 
-                if (view->pending_fullscreen() && view->is_mapped())
-                {
-                    wf::get_core().default_wm->fullscreen_request(view, nullptr, false);
-                }
+            if (view->pending_fullscreen() && view->is_mapped())
+            {
+                wf::get_core().default_wm->fullscreen_request(view, nullptr, false);
+            }
 
-                if (reinsert && view->get_output())
-                {
-                    wf::scene::readd_front(view->get_output()->wset()->get_node(), view->get_root_node());
-                }
+            if (reinsert && view->get_output())
+            {
+                wf::scene::readd_front(view->get_output()->wset()->get_node(), view->get_root_node());
             }
         }
 
@@ -299,7 +299,7 @@ void resize_view_controller_t::input_motion()
         return;
     }
 
-    auto tx = wf::txn::transaction_t::create();
+    layout_batch_t batch;
     if (horizontal_pair.first && horizontal_pair.second)
     {
         int dy = input.y - last_point.y;
@@ -308,8 +308,8 @@ void resize_view_controller_t::input_motion()
         auto g2 = horizontal_pair.second->geometry;
 
         adjust_geometry(g1.y, g1.height, g2.y, g2.height, dy);
-        horizontal_pair.first->set_geometry(g1, tx);
-        horizontal_pair.second->set_geometry(g2, tx);
+        horizontal_pair.first->set_geometry(g1, batch);
+        horizontal_pair.second->set_geometry(g2, batch);
     }
 
     if (vertical_pair.first && vertical_pair.second)
@@ -320,11 +320,10 @@ void resize_view_controller_t::input_motion()
         auto g2 = vertical_pair.second->geometry;
 
         adjust_geometry(g1.x, g1.width, g2.x, g2.width, dx);
-        vertical_pair.first->set_geometry(g1, tx);
-        vertical_pair.second->set_geometry(g2, tx);
+        vertical_pair.first->set_geometry(g1, batch);
+        vertical_pair.second->set_geometry(g2, batch);
     }
 
-    wf::get_core().tx_manager->schedule_transaction(std::move(tx));
     this->last_point = input;
 }
 
@@ -14,12 +14,91 @@
 #include <wayfire/toplevel.hpp>
 #include <wayfire/txn/transaction-manager.hpp>
 #include <wayfire/window-manager.hpp>
+#include <algorithm>
 
 namespace wf
 {
 namespace tile
 {
-void tree_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr&)
+/* ---------------------- layout_batch_t implementation --------------------- */
+layout_batch_t *layout_batch_t::active = nullptr;
+layout_batch_t::apply_callback_t layout_batch_t::apply_views = layout_batch_t::apply_in_transaction;
+
+layout_batch_t::layout_batch_t(bool dry_run)
+{
+    this->dry_run = dry_run;
+    if (dry_run)
+    {
+        return;
+    }
+
+    if (active)
+    {
+        outer = active;
+    } else
+    {
+        active = this;
+    }
+}
+
+layout_batch_t::~layout_batch_t()
+{
+    if (active == this)
+    {
+        active = nullptr;
+        commit();
+    }
+}
+
+void layout_batch_t::add(wayfire_toplevel_view view)
+{
+    if (dry_run)
+    {
+        return;
+    }
+
+    if (outer)
+    {
+        return outer->add(view);
+    }
+
+    views.push_back(view);
+}
+
+void layout_batch_t::commit()
+{
+    // A view may be resized several times during one operation, it is enough to apply its final geometry
+    std::sort(views.begin(), views.end());
+    views.erase(std::unique(views.begin(), views.end()), views.end());
+
+    auto collected = std::move(views);
+    views.clear();
+    if (!collected.empty())
+    {
+        apply_views(collected);
+    }
+}
+
+void layout_batch_t::apply_in_transaction(const std::vector<wayfire_toplevel_view>& views)
+{
+    auto tx = wf::txn::transaction_t::create();
+    for (auto& view : views)
+    {
+        // Views which were removed from the tree in the meantime are not tiled anymore
+        if (auto node = view_node_t::get_node(view))
+        {
+            node->apply_geometry(tx);
+        }
+    }
+
+    if (!tx->get_objects().empty())
+    {
+        wf::get_core().tx_manager->schedule_transaction(std::move(tx));
+    }
+}
+
+/* ----------------------- tree_node_t implementation ----------------------- */
+void tree_node_t::set_geometry(wf::geometry_t geometry, layout_batch_t&)
 {
     this->geometry = geometry;
 }
@@ -54,9 +133,9 @@ wf::geometry_t get_wset_local_coordinates(std::shared_ptr<wf::workspace_set_t> w
 
 /* ---------------------- split_node_t implementation ----------------------- */
 wf::geometry_t split_node_t::get_child_geometry(
-    int32_t child_pos, int32_t child_size)
+    wf::geometry_t available, int32_t child_pos, int32_t child_size) const
 {
-    wf::geometry_t child_geometry = this->geometry;
+    wf::geometry_t child_geometry = available;
     switch (get_split_direction())
     {
       case SPLIT_HORIZONTAL:
@@ -92,7 +171,7 @@ int32_t split_node_t::calculate_splittable() const
     return calculate_splittable(this->geometry);
 }
 
-void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::transaction_uptr& tx)
+void split_node_t::recalculate_children(wf::geometry_t available, layout_batch_t& batch)
 {
     if (this->children.empty())
     {
@@ -128,11 +207,11 @@ void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::trans
 
         /* Set new size */
         int32_t child_size = child_end - child_start;
-        child->set_geometry(get_child_geometry(child_start, child_size), tx);
+        child->set_geometry(get_child_geometry(available, child_start, child_size), batch);
     }
 }
 
-void split_node_t::add_child(std::unique_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx, int index)
+void split_node_t::add_child(std::unique_ptr<tree_node_t> child, layout_batch_t& batch, int index)
 {
     /*
      * Strategy:
@@ -161,18 +240,18 @@ void split_node_t::add_child(std::unique_ptr<tree_node_t> child, wf::txn::transa
     child->parent = {this};
 
     // Set size of the child to make sure it gets properly recalculated later
-    child->geometry = get_child_geometry(0, size_new_child);
+    child->geometry = get_child_geometry(geometry, 0, size_new_child);
 
     this->children.emplace(this->children.begin() + index, std::move(child));
 
     set_gaps(this->gaps);
 
     /* Recalculate geometry */
-    recalculate_children(geometry, tx);
+    recalculate_children(geometry, batch);
 }
 
 std::unique_ptr<tree_node_t> split_node_t::remove_child(
-    nonstd::observer_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx)
+    nonstd::observer_ptr<tree_node_t> child, layout_batch_t& batch)
 {
     /* Remove child */
     std::unique_ptr<tree_node_t> result;
@@ -191,16 +270,16 @@ std::unique_ptr<tree_node_t> split_node_t::remove_child(
     }
 
     /* Remaining children have the full geometry */
-    recalculate_children(this->geometry, tx);
+    recalculate_children(this->geometry, batch);
     result->parent = nullptr;
 
     return result;
 }
 
-void split_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
+void split_node_t::set_geometry(wf::geometry_t geometry, layout_batch_t& batch)
 {
-    tree_node_t::set_geometry(geometry, tx);
-    recalculate_children(geometry, tx);
+    tree_node_t::set_geometry(geometry, batch);
+    recalculate_children(geometry, batch);
 }
 
 void split_node_t::set_gaps(const gap_size_t& gaps)
@@ -337,9 +416,15 @@ class tile_view_animation_t : public wf::grid::grid_animation_t
     tile_view_animation_t& operator =(tile_view_animation_t&&) = delete;
 };
 
-view_node_t::view_node_t(wayfire_toplevel_view view)
+view_node_t::view_node_t(wayfire_toplevel_view view, bool attach)
 {
-    this->view = view;
+    this->view     = view;
+    this->attached = attach;
+    if (!attach)
+    {
+        return;
+    }
+
     wf::dassert(!view->has_data<view_node_custom_data_t>(), "View already has custom data!");
     view->store_data(std::make_unique<view_node_custom_data_t>(this));
 
@@ -358,6 +443,11 @@ view_node_t::view_node_t(wayfire_toplevel_view view)
 
 view_node_t::~view_node_t()
 {
+    if (!attached)
+    {
+        return;
+    }
+
     view->get_transformed_node()->rem_transformer(scale_transformer_name);
     view->erase_data<view_node_custom_data_t>();
 }
@@ -480,20 +570,44 @@ static nonstd::observer_ptr<wf::grid::grid_animation_t> ensure_animation(
     return view->get_data<wf::grid::grid_animation_t>();
 }
 
-void view_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
+void stop_view_animations()
 {
-    tree_node_t::set_geometry(geometry, tx);
+    for (auto& view : wf::get_core().get_all_views())
+    {
+        auto animation = view->get_data<wf::grid::grid_animation_t>();
+        if (animation && dynamic_cast<tile_view_animation_t*>(animation.get()))
+        {
+            view->erase_data<wf::grid::grid_animation_t>();
+        }
+    }
+}
+
+void view_node_t::set_geometry(wf::geometry_t geometry, layout_batch_t& batch)
+{
+    tree_node_t::set_geometry(geometry, batch);
+    if (attached)
+    {
+        batch.add(view);
+    }
+}
 
+bool view_node_t::apply_geometry(wf::txn::transaction_uptr& tx)
+{
     if (!view->is_mapped())
     {
-        return;
+        return false;
+    }
+
+    auto target = calculate_target_geometry();
+    if (is_tiled_state_pending(view->toplevel()->pending(), view->toplevel()->current(), target))
+    {
+        return false;
     }
 
     wf::get_core().default_wm->update_last_windowed_geometry(view);
     view->toplevel()->pending().tiled_edges = TILED_EDGES_ALL;
     tx->add_object(view->toplevel());
 
-    auto target = calculate_target_geometry();
     if (this->needs_crossfade() && (target != view->get_geometry()))
     {
         view->get_transformed_node()->rem_transformer(scale_transformer_name);
@@ -502,8 +616,16 @@ void view_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_upt
     } else
     {
         view->toplevel()->pending().geometry = target;
-        tx->add_object(view->toplevel());
     }
+
+    return true;
+}
+
+bool view_node_t::is_tiled_state_pending(const wf::toplevel_state_t& pending,
+    const wf::toplevel_state_t& current, wf::geometry_t target)
+{
+    return (pending.geometry == target) && (pending.tiled_edges == TILED_EDGES_ALL) &&
+           (pending.fullscreen == current.fullscreen);
 }
 
 void view_node_t::update_transformer()
@@ -543,6 +665,29 @@ nonstd::observer_ptr<view_node_t> view_node_t::get_node(wayfire_view view)
 }
 
 /* ----------------- Generic tree operations implementation ----------------- */
+std::unique_ptr<tree_node_t> clone_tree(nonstd::observer_ptr<tree_node_t> node)
+{
+    std::unique_ptr<tree_node_t> copy;
+    if (auto view_node = node->as_view_node())
+    {
+        auto view_copy = std::make_unique<view_node_t>(view_node->view, false);
+        view_copy->show_maximized = view_node->show_maximized;
+        copy = std::move(view_copy);
+    } else
+    {
+        copy = std::make_unique<split_node_t>(node->as_split_node()->get_split_direction());
+        for (auto& child : node->children)
+        {
+            copy->children.push_back(clone_tree({child}));
+            copy->children.back()->parent = copy->as_split_node();
+        }
+    }
+
+    copy->geometry = node->geometry;
+    copy->set_gaps(node->get_gaps());
+    return copy;
+}
+
 bool flatten_tree(std::unique_ptr<tree_node_t>& root)
 {
     /* Cannot flatten a view node */
@@ -7,6 +7,8 @@
 #include <wayfire/view.hpp>
 #include <wayfire/option-wrapper.hpp>
 #include <wayfire/txn/transaction.hpp>
+#include <wayfire/toplevel.hpp>
+#include <functional>
 
 namespace wf
 {
@@ -23,6 +25,55 @@ namespace tile
 struct split_node_t;
 struct view_node_t;
 
+/**
+ * Collects the views whose tree nodes got a new geometry during an operation on the tiling trees, and
+ * applies the new geometries to all of them at once, in a single transaction, when the batch is destroyed.
+ * Views whose geometry does not change are skipped.
+ *
+ * Batches can be nested: a batch created while another one is alive adds its views to the outermost batch,
+ * so that operations made of several smaller ones (for example detaching a view and attaching it on another
+ * workspace) still result in one transaction.
+ *
+ * A dry-run batch never touches views. Together with clone_tree(), it can be used to find out how the views
+ * would be laid out after an operation, without actually doing it.
+ */
+class layout_batch_t
+{
+  public:
+    layout_batch_t(bool dry_run = false);
+    ~layout_batch_t();
+
+    layout_batch_t(const layout_batch_t&) = delete;
+    layout_batch_t(layout_batch_t&&) = delete;
+    layout_batch_t& operator =(const layout_batch_t&) = delete;
+    layout_batch_t& operator =(layout_batch_t&&) = delete;
+
+    /** Apply the geometry of the view's tree node when the batch is committed. */
+    void add(wayfire_toplevel_view view);
+
+    using apply_callback_t = std::function<void (const std::vector<wayfire_toplevel_view>&)>;
+
+    /**
+     * Called by the outermost batch with the collected views, each of them once. By default, it applies the
+     * geometry of each view's tree node in a single transaction. Tests replace it to observe the commits.
+     */
+    static apply_callback_t apply_views;
+
+    /** Apply the geometry of the views' tree nodes in a single transaction. */
+    static void apply_in_transaction(const std::vector<wayfire_toplevel_view>& views);
+
+  private:
+    /* The outermost real batch which is currently alive */
+    static layout_batch_t *active;
+    layout_batch_t *outer = nullptr;
+    bool dry_run;
+
+    std::vector<wayfire_toplevel_view> views;
+
+    /** Apply the new geometries of all collected views in one transaction. */
+    void commit();
+};
+
 struct gap_size_t
 {
     /* Gap on the left side */
@@ -48,8 +99,11 @@ struct tree_node_t
     /** The geometry occupied by the node */
     wf::geometry_t geometry;
 
-    /** Set the geometry available for the node and its subnodes. */
-    virtual void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx);
+    /**
+     * Set the geometry available for the node and its subnodes. The geometry of the affected views is updated
+     * when the batch is committed.
+     */
+    virtual void set_geometry(wf::geometry_t geometry, layout_batch_t& batch);
 
     /** Set the gaps for the node and subnodes. */
     virtual void set_gaps(const gap_size_t& gaps) = 0;
@@ -96,20 +150,20 @@ struct split_node_t : public tree_node_t
      * @param index The index at which to insert the new child, or -1 for
      *              adding to the end of the child list.
      */
-    void add_child(std::unique_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx, int index = -1);
+    void add_child(std::unique_ptr<tree_node_t> child, layout_batch_t& batch, int index = -1);
 
     /**
      * Remove a child from the node, and return its unique_ptr
      */
     std::unique_ptr<tree_node_t> remove_child(
-        nonstd::observer_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx);
+        nonstd::observer_ptr<tree_node_t> child, layout_batch_t& batch);
 
     /**
      * Set the total geometry available to the node. This will recursively
      * resize the children nodes, so that they fit inside the new geometry and
      * have a size proportional to their old size.
      */
-    void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
+    void set_geometry(wf::geometry_t geometry, layout_batch_t& batch) override;
 
     /**
      * Set the gaps for the subnodes. The internal gap will override
@@ -127,7 +181,7 @@ struct split_node_t : public tree_node_t
      * Resize the children so that they fit inside the given
      * available_geometry.
      */
-    void recalculate_children(wf::geometry_t available_geometry, wf::txn::transaction_uptr& tx);
+    void recalculate_children(wf::geometry_t available_geometry, layout_batch_t& batch);
 
     /**
      * Calculate the geometry of a child if it has child_size as one
@@ -138,7 +192,7 @@ struct split_node_t : public tree_node_t
      *
      * @return The geometry of the child, in global coordinates
      */
-    wf::geometry_t get_child_geometry(int32_t child_pos, int32_t child_size);
+    wf::geometry_t get_child_geometry(wf::geometry_t available, int32_t child_pos, int32_t child_size) const;
 
     /** Return the size of the node in the dimension in which the split happens */
     int32_t calculate_splittable() const;
@@ -155,19 +209,41 @@ struct tile_adjust_transformer_signal
  */
 struct view_node_t : public tree_node_t
 {
-    view_node_t(wayfire_toplevel_view view);
+    /**
+     * @param attach Whether the node is the tree node of the view. Detached nodes are used for copies of the
+     *   tree (see clone_tree()), they are not returned by get_node() and never change the view.
+     */
+    view_node_t(wayfire_toplevel_view view, bool attach = true);
     ~view_node_t();
 
     wayfire_toplevel_view view;
 
     /**
-     * Set the geometry of the node and the contained view.
+     * Set the geometry of the node, and schedule the contained view to be resized when the batch is
+     * committed.
      *
      * Note that the resulting view geometry will not always be equal to the
      * geometry of the node. For example, a fullscreen view will always have
      * the geometry of the whole output.
      */
-    void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
+    void set_geometry(wf::geometry_t geometry, layout_batch_t& batch) override;
+
+    /**
+     * Add the view to the transaction with the geometry its node currently has.
+     *
+     * @return False if the view already has this geometry, in which case nothing is done.
+     */
+    bool apply_geometry(wf::txn::transaction_uptr& tx);
+
+    /**
+     * Whether a view with the given pending and current state already has the tiled state with the given
+     * geometry, so that it does not need to be added to a transaction again.
+     */
+    static bool is_tiled_state_pending(const wf::toplevel_state_t& pending,
+        const wf::toplevel_state_t& current, wf::geometry_t target);
+
+    /** The geometry the view gets with the current geometry of the node. */
+    wf::geometry_t calculate_target_geometry();
 
     /**
      * When true, the view will occupy the entire workarea (minus gaps),
@@ -184,6 +260,8 @@ struct view_node_t : public tree_node_t
     static nonstd::observer_ptr<view_node_t> get_node(wayfire_view view);
 
   private:
+    bool attached;
+
     struct scale_transformer_t;
     nonstd::observer_ptr<scale_transformer_t> transformer;
 
@@ -199,8 +277,6 @@ struct view_node_t : public tree_node_t
      * currently.
      */
     bool needs_crossfade();
-
-    wf::geometry_t calculate_target_geometry();
     void update_transformer();
 };
 
@@ -217,11 +293,23 @@ struct view_node_t : public tree_node_t
  */
 bool flatten_tree(std::unique_ptr<tree_node_t>& root);
 
+/**
+ * Create a copy of the subtree, for example to lay it out in a dry-run batch. The view nodes of the copy
+ * refer to the same views, but they are detached from them, so changing the copy affects neither the tree
+ * nor the views.
+ */
+std::unique_ptr<tree_node_t> clone_tree(nonstd::observer_ptr<tree_node_t> node);
+
 /**
  * Get the root of the tree which node is part of
  */
 nonstd::observer_ptr<split_node_t> get_root(nonstd::observer_ptr<tree_node_t> node);
 
+/**
+ * Stop the running tile animations of all views, so that they do not run after the plugin is unloaded.
+ */
+void stop_view_animations();
+
 /**
  * Transform coordinates from the tiling trees coordinate system to wset-local coordinates.
  */
@@ -58,6 +58,11 @@ class wayfire_window_rules_t : public wf::per_output_plugin_instance_t
     // Auto-reload on changes to config file
     wf::signal::connection_t<wf::reload_config_signal> _reload_config = [=] (wf::reload_config_signal *ev)
     {
+        if (!ev->section_changed("window-rules"))
+        {
+            return;
+        }
+
         setup_rules_from_config();
     };
 
@@ -72,6 +72,12 @@ class bindings_repository_t
     /** Handle a gesture from the user. */
     void handle_gesture(const wf::touchgesture_t& gesture);
 
+    /**
+     * Check whether handling the gesture would trigger any binding. A gesture with direction 0 matches
+     * bindings with any direction. Useful to give up on recognizing gestures early.
+     */
+    bool has_gesture(const wf::touchgesture_t& gesture) const;
+
     /**
      * Trigger all extension bindings which match the given tag.
      *
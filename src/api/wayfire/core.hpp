@@ -327,10 +327,21 @@ class compositor_core_t : public wf::object_base_t, public signal::provider_t
      * This also sets some environment variables for the new process, including
      * correct WAYLAND_DISPLAY and DISPLAY.
      *
-     * @return The PID of the started client, or -1 on failure.
+     * The command is started without blocking the compositor, and the shell becomes a child process of the
+     * compositor, which reaps it when it exits.
+     *
+     * @return The PID of the started client, or 0 on failure.
      */
     virtual pid_t run(std::string command) = 0;
 
+    /**
+     * Same as run(), but starts several commands at once, for example the autostart entries. The
+     * environment for the new processes is prepared only once.
+     *
+     * @return The PIDs of the started clients, in the same order as @commands. 0 for commands which failed.
+     */
+    std::vector<pid_t> run_batch(const std::vector<std::string>& commands);
+
     /**
      * @return The current state of the compositor.
      */
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct wlr_render_timer;
+struct wlr_renderer;
+struct wlr_output;
+
+namespace wf
+{
+/**
+ * Accounting of the time the compositor spends on behalf of each plugin.
+ *
+ * Plugin code is run from a few well-known places: plugin init/fini, effect and post hooks, render
+ * instances, signal handlers, bindings and IPC methods. Each of these remembers the plugin which was running
+ * when it was registered (its owner), and is later run with its owner set as the current one. This way,
+ * hooks, nodes and handlers which a plugin creates from its own callbacks are attributed to it as well.
+ *
+ * Owners are always tracked. Time is measured only while accounting is enabled.
+ * Accounting is done only on the main thread.
+ */
+namespace cost
+{
+/** An identifier of a plugin. */
+using owner_t = uint32_t;
+/** The owner of everything not created by a plugin. */
+static constexpr owner_t CORE = 0;
+
+enum class category_t
+{
+    INIT   = 0,
+    EFFECT = 1,
+    POST   = 2,
+    RENDER = 3,
+    SIGNAL = 4,
+    BINDING = 5,
+    IPC    = 6,
+    TOTAL,
+};
+
+/** Whether time is being measured. */
+extern bool enabled;
+
+/** The owner of the code which is currently running. */
+extern owner_t active_owner;
+
+inline owner_t current_owner()
+{
+    return active_owner;
+}
+
+/**
+ * Get the owner for the plugin with the given name, registering a new one if necessary.
+ */
+owner_t register_owner(const std::string& name);
+
+/**
+ * Attribute time spent in the given category to the given owner.
+ */
+void add_cpu_time(owner_t owner, category_t category, std::chrono::nanoseconds time);
+
+/**
+ * Attach a GPU timer to the render pass which is about to start. The time it measures is attributed to the
+ * current owner once it is available, which is when the output painted last starts its next frame.
+ *
+ * @return The timer to pass to wlr_renderer_begin_buffer_pass(), or NULL if accounting is disabled or the
+ *   renderer does not support timers.
+ */
+wlr_render_timer *create_gpu_timer(wlr_renderer *renderer);
+
+/**
+ * Called when @output starts painting a new frame. Reads out the GPU timers of render passes which were
+ * started during the previous frames of the same output, and attributes new timers to this output.
+ */
+void collect_gpu_timers(wlr_output *output);
+
+/**
+ * Drop the pending timers of an output which is being destroyed, without reading them.
+ */
+void forget_output(wlr_output *output);
+
+/**
+ * Run code on behalf of @owner until the scope is destroyed. While accounting is enabled, the time spent in
+ * the scope, excluding nested scopes, is attributed to the owner.
+ */
+class scope_t
+{
+  public:
+    scope_t(owner_t owner, category_t category)
+    {
+        this->owner    = owner;
+        this->category = category;
+        this->prev_owner = active_owner;
+        active_owner     = owner;
+
+        if (enabled)
+        {
+            parent = active_scope;
+            active_scope = this;
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~scope_t()
+    {
+        active_owner = prev_owner;
+        if (active_scope != this)
+        {
+            // Accounting was enabled while the scope was running
+            return;
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        active_scope = parent;
+        if (parent)
+        {
+            parent->nested += elapsed;
+        }
+
+        add_cpu_time(owner, category, elapsed - nested);
+    }
+
+    scope_t(const scope_t&) = delete;
+    scope_t(scope_t&&) = delete;
+    scope_t& operator =(const scope_t&) = delete;
+    scope_t& operator =(scope_t&&) = delete;
+
+  private:
+    static scope_t *active_scope;
+
+    owner_t owner;
+    owner_t prev_owner;
+    category_t category;
+
+    scope_t *parent = nullptr;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds nested{0};
+};
+
+struct owner_stats_t
+{
+    std::string name;
+    /* Average CPU time per second, for each category */
+    std::chrono::nanoseconds cpu[(int)category_t::TOTAL];
+    /* Average GPU time per second */
+    std::chrono::nanoseconds gpu;
+};
+
+/**
+ * Get the average time per second spent on behalf of each owner over the last few seconds.
+ */
+std::vector<owner_stats_t> get_stats();
+
+/**
+ * Get a human-readable name of the category.
+ */
+const char *get_category_name(category_t category);
+
+/**
+ * Enable or disable accounting. Enabling it clears the collected statistics.
+ */
+void set_enabled(bool enabled);
+}
+}
@@ -2,6 +2,8 @@
 #define IMG_HPP_
 
 #include <wayfire/opengl.hpp>
+#include <functional>
+#include <optional>
 #include <string>
 
 namespace image_io
@@ -17,6 +19,25 @@ void write_to_file(std::string name, uint8_t *pixels, int w, int h,
 
 void write_to_file(std::string name, const wf::render_buffer_t& buffer);
 
+/* Formats supported by write_to_file_async() */
+enum class image_format_t
+{
+    PNG,
+    /* The "Quite OK Image" format: lossless, much faster to encode than PNG. */
+    QOI,
+    /* Uncompressed RGBA pixels in a Netpbm PAM container. */
+    PAM,
+};
+
+/* Parse a format name ("png", "qoi", "raw" or "pam") */
+std::optional<image_format_t> parse_image_format(const std::string& name);
+
+/* Read back the contents of the buffer and save them to the given file without blocking the compositor.
+ * The pixels are read back immediately, then encoded and written in a background thread.
+ * on_done is called on the main loop with whether the file was written successfully. */
+void write_to_file_async(std::string name, const wf::render_buffer_t& buffer, image_format_t format,
+    std::function<void(bool)> on_done = {});
+
 /* Initializes all backends, called at startup */
 void init();
 }
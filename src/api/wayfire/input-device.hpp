@@ -2,6 +2,7 @@
 #define WF_INPUT_DEVICE_HPP
 
 #include <wayfire/nonstd/wlroots.hpp>
+#include <cstdint>
 
 namespace wf
 {
@@ -27,6 +28,17 @@ class input_device_t
     bool is_enabled();
     virtual ~input_device_t() = default;
 
+    /** Counters of the relative motion events of pointer devices. */
+    struct motion_stats_t
+    {
+        /* All motion events received from the device */
+        uint64_t received = 0;
+        /* Motion events merged into an earlier one, see the input/coalesce_motion option */
+        uint64_t merged = 0;
+    };
+
+    motion_stats_t motion_stats;
+
   protected:
     wlr_input_device *handle;
     input_device_t(wlr_input_device *handle);
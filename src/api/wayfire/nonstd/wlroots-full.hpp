@@ -31,6 +31,7 @@ extern "C"
 #include <wlr/render/swapchain.h>
 #include <wlr/render/allocator.h>
 #include <wlr/render/color.h>
+#include <wlr/render/drm_syncobj.h>
 
 #if WLR_HAS_GLES2_RENDERER
     #include <wlr/render/gles2.h>
@@ -13,6 +13,7 @@ extern "C"
 {
     struct wlr_backend;
     struct wlr_renderer;
+    struct wlr_drm_syncobj_timeline;
     struct wlr_seat;
     struct wlr_cursor;
     struct wlr_data_device_manager;
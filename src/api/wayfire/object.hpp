@@ -45,6 +45,26 @@ class object_base_t
     /** Get the ID of the object. Each object has a unique ID */
     uint32_t get_id() const;
 
+    /**
+     * Retrieve custom data of type T. If no such data exists, then it is
+     * created with the default constructor.
+     *
+     * REQUIRES a default constructor
+     * If your type doesn't have one, use store_data + get_data
+     */
+    template<class T>
+    nonstd::observer_ptr<T> get_data_safe()
+    {
+        auto data = get_data<T>();
+        if (data)
+        {
+            return data;
+        }
+
+        store_data<T>(std::make_unique<T>());
+        return get_data<T>();
+    }
+
     /**
      * Retrieve custom data stored with the given name. If no such data exists,
      * then it is created with the default constructor.
@@ -53,8 +73,7 @@ class object_base_t
      * If your type doesn't have one, use store_data + get_data
      */
     template<class T>
-    nonstd::observer_ptr<T> get_data_safe(
-        std::string name = typeid(T).name())
+    nonstd::observer_ptr<T> get_data_safe(std::string name)
     {
         auto data = get_data<T>(name);
         if (data)
@@ -68,28 +87,43 @@ class object_base_t
         }
     }
 
+    /* Retrieve custom data of type T. If no such data exists, NULL is returned.
+     *
+     * Data stored by type lives in a slot assigned to the type, so the lookup
+     * does not involve strings or a dynamic_cast. */
+    template<class T>
+    nonstd::observer_ptr<T> get_data()
+    {
+        return nonstd::make_observer(static_cast<T*>(_fetch_typed(_type_slot<T>())));
+    }
+
     /* Retrieve custom data stored with the given name. If no such
      * data exists, NULL is returned */
     template<class T>
-    nonstd::observer_ptr<T> get_data(
-        std::string name = typeid(T).name())
+    nonstd::observer_ptr<T> get_data(std::string name)
     {
         return nonstd::make_observer(dynamic_cast<T*>(_fetch_data(name)));
     }
 
+    /* Assigns the given data to the slot of type T */
+    template<class T>
+    void store_data(std::unique_ptr<T> stored_data)
+    {
+        _store_typed(_type_slot<T>(), std::move(stored_data));
+    }
+
     /* Assigns the given data to the given name */
     template<class T>
-    void store_data(std::unique_ptr<T> stored_data,
-        std::string name = typeid(T).name())
+    void store_data(std::unique_ptr<T> stored_data, std::string name)
     {
         _store_data(std::move(stored_data), name);
     }
 
-    /* Returns true if there is saved data under the given name */
+    /* Returns true if there is saved data of type T */
     template<class T>
     bool has_data()
     {
-        return has_data(typeid(T).name());
+        return _fetch_typed(_type_slot<T>()) != nullptr;
     }
 
     /** @return true if there is saved data with the given name */
@@ -102,13 +136,19 @@ class object_base_t
     template<class T>
     void erase_data()
     {
-        erase_data(typeid(T).name());
+        _erase_typed(_type_slot<T>());
+    }
+
+    /* Erase the saved data of type T from the store and return the pointer */
+    template<class T>
+    std::unique_ptr<T> release_data()
+    {
+        return std::unique_ptr<T>(static_cast<T*>(_release_typed(_type_slot<T>())));
     }
 
     /* Erase the saved data from the store and return the pointer */
     template<class T>
-    std::unique_ptr<T> release_data(
-        std::string name = typeid(T).name())
+    std::unique_ptr<T> release_data(std::string name)
     {
         if (!has_data(name))
         {
@@ -190,6 +230,28 @@ class object_base_t
 
     void _warn_wrong_type(std::string name);
 
+    /**
+     * Get the slot for data of type T. Slots are assigned on first use and are
+     * the same in the core and all plugins.
+     */
+    template<class T>
+    static uint32_t _type_slot()
+    {
+        static const uint32_t slot = _allocate_type_slot(typeid(T));
+        return slot;
+    }
+
+    static uint32_t _allocate_type_slot(const std::type_info& type);
+
+    /** Get the data in the given slot, or nullptr, if it does not exist */
+    custom_data_t *_fetch_typed(uint32_t slot);
+    /** Store the given data in the given slot, replacing the existing data */
+    void _store_typed(uint32_t slot, std::unique_ptr<custom_data_t> data);
+    /** Remove and destroy the data in the given slot */
+    void _erase_typed(uint32_t slot);
+    /** Remove the data in the given slot and release the pointer */
+    custom_data_t *_release_typed(uint32_t slot);
+
     class obase_impl;
     std::unique_ptr<obase_impl> obase_priv;
 };
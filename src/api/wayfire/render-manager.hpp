@@ -51,6 +51,39 @@ enum output_effect_type_t
 using post_hook_t = std::function<void (wf::auxilliary_buffer_t& source,
     const wf::render_buffer_t& destination)>;
 
+/**
+ * Describes which pixels of the source buffer a post hook reads to compute a pixel of its destination.
+ *
+ * Post hooks which declare a local footprint are run only on the damaged parts of the output, expanded by
+ * the footprint of all hooks in the chain, instead of on the whole output each frame.
+ */
+struct post_hook_footprint_t
+{
+    /**
+     * The hook may read any pixel of the source for each destination pixel (for example, zooming), so the
+     * whole output is processed and swapped whenever something changes.
+     */
+    bool whole_output = true;
+
+    /**
+     * If whole_output is false, the maximal distance (in buffer pixels) between a destination pixel and the
+     * source pixels it depends on. 0 for per-pixel effects like color transformations.
+     */
+    int radius = 0;
+
+    /** A footprint for effects which read only the corresponding source pixel. */
+    static post_hook_footprint_t per_pixel()
+    {
+        return {false, 0};
+    }
+
+    /** A footprint for effects which read the pixels in the given radius, for example blurring. */
+    static post_hook_footprint_t neighborhood(int radius)
+    {
+        return {false, radius};
+    }
+};
+
 /**
  * The frame-done signal is emitted on an output when the frame has been completed (regardless of whether new
  * content was painted or not).
@@ -112,8 +145,10 @@ class render_manager
      * Add a new post hook.
      *
      * @param hook The hook callback
+     * @param footprint The pixels the hook reads for each output pixel. Hooks with a local footprint
+     *   should restrict their rendering to get_post_damage().
      */
-    void add_post(post_hook_t *hook);
+    void add_post(post_hook_t *hook, post_hook_footprint_t footprint = {});
 
     /**
      * Remove a post hook. No-op if hook isn't active.
@@ -130,6 +165,14 @@ class render_manager
      */
     wf::region_t get_swap_damage();
 
+    /**
+     * @return The region of the destination buffer (in buffer-local coordinates) which the currently
+     * running post hook has to update. The source buffer is guaranteed to be up-to-date in this region,
+     * expanded by the radius of the hook's footprint. Updating more than that is allowed but wasteful.
+     * Returns an empty region if called outside of a post hook.
+     */
+    wf::region_t get_post_damage();
+
     /**
      * @return The current render pass, NULL if no rendering operations are currently active on the output.
      */
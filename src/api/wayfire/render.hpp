@@ -6,6 +6,8 @@
 #include <wayfire/nonstd/wlroots.hpp>
 #include <wayfire/geometry.hpp>
 #include <wayfire/region.hpp>
+#include <wayfire/util.hpp>
+#include <functional>
 #include <optional>
 
 namespace wf
@@ -25,6 +27,87 @@ struct texture_t
 
 struct auxilliary_buffer_t;
 
+/**
+ * A pending asynchronous wait for a render fence, see render_fence_t::wait_async().
+ * Destroying the object cancels the wait.
+ */
+class render_fence_waiter_t
+{
+  public:
+    ~render_fence_waiter_t();
+
+  private:
+    friend class render_fence_t;
+    render_fence_waiter_t() = default;
+    void run_callback();
+
+    int fd = -1;
+    wl_event_source *source = NULL;
+    wf::wl_idle_call idle;
+    std::function<void()> callback;
+};
+
+/**
+ * A fence which is signaled when the GPU has finished executing a render pass.
+ *
+ * Fences allow consumers of the rendered buffer (post hooks, other renderers, etc.) to wait for the results
+ * without stalling the CPU with glFinish().
+ *
+ * A default-constructed fence does not carry a sync point and is treated as already signaled. This is the
+ * case for passes executed by the pixman renderer, which renders synchronously. Note that renderers without
+ * timeline support also do not produce fences, in which case consumers have to rely on implicit sync.
+ */
+class render_fence_t
+{
+  public:
+    render_fence_t() = default;
+    render_fence_t(wlr_drm_syncobj_timeline *timeline, uint64_t point);
+    ~render_fence_t();
+
+    render_fence_t(const render_fence_t& other);
+    render_fence_t& operator =(const render_fence_t& other);
+
+    /**
+     * Whether the fence carries a sync point, as opposed to being trivially signaled.
+     */
+    bool has_sync_point() const;
+
+    /**
+     * Check without blocking whether the fence has been signaled.
+     */
+    bool is_signaled() const;
+
+    /**
+     * Export the fence as a sync_file.
+     *
+     * @return A new file descriptor owned by the caller, or -1 if the fence has no sync point or the export
+     *   failed.
+     */
+    int export_sync_file() const;
+
+    /**
+     * Run the callback on the main event loop once the fence is signaled.
+     * If the fence is already signaled, the callback is run when the event loop goes idle.
+     *
+     * @return An object representing the wait. Destroying it cancels the wait.
+     */
+    std::unique_ptr<render_fence_waiter_t> wait_async(std::function<void()> callback) const;
+
+    wlr_drm_syncobj_timeline *get_timeline() const
+    {
+        return timeline;
+    }
+
+    uint64_t get_point() const
+    {
+        return point;
+    }
+
+  private:
+    wlr_drm_syncobj_timeline *timeline = NULL;
+    uint64_t point = 0;
+};
+
 /**
  * A simple wrapper for buffers which are used as render targets.
  * Note that a renderbuffer does not assume any ownership of the buffer.
@@ -165,13 +248,92 @@ struct auxilliary_buffer_t
      */
     wlr_texture *get_texture();
 
+    /**
+     * Set the fence which is signaled when the last rendering operation on the buffer completes.
+     * Producers which render to the buffer with RPASS_SIGNAL_FENCE should set it after submitting the pass.
+     */
+    void set_ready_fence(const render_fence_t& fence);
+
+    /**
+     * Get the fence which consumers of the buffer's contents should wait on before reading them.
+     */
+    const render_fence_t& get_ready_fence() const;
+
   private:
     render_buffer_t buffer;
+    render_fence_t ready_fence;
 
     // The wlr_texture creating from this framebuffer.
     wlr_texture *texture = NULL;
 };
 
+/**
+ * A history of the damage of the last frames, used to find out which parts of a buffer have to be repainted
+ * when the buffer is reused.
+ *
+ * Unlike the damage ring of wlroots, any number of buffers can be tracked, and the buffers are identified by
+ * an opaque key. Buffers which were never painted, or were last painted too many frames ago, have to be
+ * repainted fully.
+ *
+ * The output uses it for its swapchain buffers and for the postprocessing scene buffer. It is useful only
+ * for several buffers which share one source of damage and are painted in turns. A single buffer with its
+ * own damage, like the transformers' inner_content or the workspace wall's per-workspace buffers, needs
+ * just a region which accumulates the damage until the next repaint.
+ */
+class damage_history_t
+{
+  public:
+    /**
+     * @param max_age The number of past frames to keep. Buffers older than this are repainted fully.
+     */
+    damage_history_t(int max_age = 4);
+
+    /**
+     * Add damage to the current frame.
+     */
+    void add(const wf::region_t& damage);
+
+    /**
+     * Get the damage which was added since the last call to rotate().
+     */
+    const wf::region_t& get_pending() const;
+
+    /**
+     * Start a new frame: the pending damage becomes part of the history.
+     */
+    void rotate();
+
+    /**
+     * Get the region which has to be repainted in the given buffer to bring it up to date with all damage
+     * up to the last rotate(), clipped to @extents.
+     */
+    wf::region_t get_buffer_damage(const void *buffer, const wf::geometry_t& extents) const;
+
+    /**
+     * Mark the buffer as up to date with all damage up to the last rotate().
+     */
+    void mark_painted(const void *buffer);
+
+    /**
+     * Forget the given buffer, for example because it was destroyed or reallocated.
+     * The next time it is used, it will have to be repainted fully.
+     */
+    void forget(const void *buffer);
+
+    /**
+     * Forget all buffers.
+     */
+    void forget_all();
+
+  private:
+    int max_age;
+    uint64_t current_frame = 0;
+    wf::region_t pending;
+    // The damage of the last frames, newest at the back.
+    std::vector<wf::region_t> history;
+    std::vector<std::pair<const void*, uint64_t>> painted;
+};
+
 /**
  * A render target contains a render buffer and information on how to map
  * coordinates from the logical coordinate space (output-local coordinates, etc.)
@@ -274,6 +436,10 @@ enum render_pass_flags
      * Do not clear the background areas.
      */
     RPASS_CLEAR_BACKGROUND = (1 << 1),
+    /**
+     * Signal a fence when the GPU is done with the pass, see render_pass_t::get_fence().
+     */
+    RPASS_SIGNAL_FENCE     = (1 << 2),
 };
 
 /**
@@ -326,6 +492,7 @@ class render_pass_t
 {
     render_pass_params_t params;
     wlr_render_pass *pass = NULL;
+    render_fence_t fence;
 
   public:
     render_pass_t(const render_pass_params_t& params);
@@ -375,6 +542,19 @@ class render_pass_t
      */
     wlr_render_pass *get_wlr_pass();
 
+    /**
+     * Simplify a heavily fragmented damage region.
+     *
+     * Every render operation is executed once per rectangle of its damage region, so for damage which
+     * consists of many small rectangles it is usually cheaper to repaint the bounding box of the damage
+     * instead. The bounding box is returned if the estimated cost of the additional pixels is lower than
+     * the cost of the additional draw calls, otherwise the damage is returned unchanged.
+     *
+     * Passes which clear the background (RPASS_CLEAR_BACKGROUND) do this automatically after
+     * render-pass-begin has been emitted.
+     */
+    static wf::region_t coalesce_damage(const wf::region_t& damage);
+
     /**
      * Clear the given region (relative to the render target's geometry) with the given color.
      */
@@ -430,6 +610,13 @@ class render_pass_t
      */
     bool submit();
 
+    /**
+     * Get the fence which is signaled when the GPU has finished executing the pass.
+     * Only valid after submit(), and only if the pass was started with RPASS_SIGNAL_FENCE. Otherwise, or if
+     * the renderer does not support explicit synchronization, the returned fence has no sync point.
+     */
+    render_fence_t get_fence() const;
+
     /**
      * A helper function for plugins which support custom OpenGL ES rendering.
      *
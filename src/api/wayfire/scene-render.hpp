@@ -8,6 +8,7 @@
 #include <wayfire/geometry.hpp>
 #include <wayfire/render.hpp>
 #include <wayfire/signal-provider.hpp>
+#include <wayfire/cost-accounting.hpp>
 
 namespace wf
 {
@@ -142,6 +143,12 @@ class render_instance_t
      */
     virtual void compute_visibility(wf::output_t *output, wf::region_t& visible)
     {}
+
+    /**
+     * The plugin on whose behalf the instance renders. By default, this is the plugin which was running when
+     * the instance was created.
+     */
+    wf::cost::owner_t cost_owner = wf::cost::current_owner();
 };
 
 using damage_callback = std::function<void (const wf::region_t&)>;
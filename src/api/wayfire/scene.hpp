@@ -8,6 +8,7 @@
 #include <wayfire/nonstd/observer_ptr.h>
 #include <wayfire/scene-input.hpp>
 #include <wayfire/signal-provider.hpp>
+#include <wayfire/cost-accounting.hpp>
 
 namespace wf
 {
@@ -358,6 +359,11 @@ class node_t : public std::enable_shared_from_this<node_t>,
     node_t& operator =(const node_t&) = delete;
     node_t& operator =(node_t&&) = delete;
 
+    /**
+     * The plugin which created the node. Render instances of the node are attributed to it.
+     */
+    wf::cost::owner_t cost_owner = wf::cost::current_owner();
+
   protected:
     bool _is_structure;
     int enabled_counter = 1;
@@ -4,6 +4,10 @@
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
 
+#include <set>
+#include <string>
+#include <algorithm>
+
 /**
  * Documentation of signals emitted from core components.
  * Each signal documentation follows the following scheme:
@@ -192,7 +196,33 @@ struct touch_focus_changed_signal
  * when: When the config file is reloaded
  */
 struct reload_config_signal
-{};
+{
+    /**
+     * The names of the config sections whose contents changed since the last
+     * reload. An empty set means that the set of changed sections is not known
+     * (for example, when options were set via IPC), in which case listeners
+     * should assume that every section might have changed.
+     */
+    std::set<std::string> changed_sections;
+
+    /** @return true if the section with the given name may have changed. */
+    bool section_changed(const std::string& name) const
+    {
+        return changed_sections.empty() || changed_sections.count(name);
+    }
+
+    /** @return true if any section whose name starts with @prefix may have changed. */
+    bool section_changed_with_prefix(const std::string& prefix) const
+    {
+        if (changed_sections.empty())
+        {
+            return true;
+        }
+
+        return std::any_of(changed_sections.begin(), changed_sections.end(),
+            [&] (const std::string& name) { return name.rfind(prefix, 0) == 0; });
+    }
+};
 
 /**
  * on: core
@@ -4,6 +4,7 @@
 #include <memory>
 #include <cassert>
 #include <typeindex>
+#include <wayfire/cost-accounting.hpp>
 
 namespace wf
 {
@@ -39,6 +40,12 @@ class connection_base_t
     /** Disconnect from all connected signal providers */
     void disconnect();
 
+    /**
+     * The plugin on whose behalf the callback is run: the plugin which created the connection, or the last
+     * plugin which connected it.
+     */
+    wf::cost::owner_t cost_owner = wf::cost::current_owner();
+
   protected:
     connection_base_t()
     {}
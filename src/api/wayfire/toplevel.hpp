@@ -4,6 +4,7 @@
 #include <wayfire/nonstd/wlroots.hpp>
 #include "wayfire/geometry.hpp"
 #include "wayfire/object.hpp"
+#include "wayfire/util.hpp"
 #include <wayfire/txn/transaction-object.hpp>
 #include "wayfire/nonstd/wlroots.hpp" // IWYU pragma: keep
 
@@ -123,7 +124,65 @@ class toplevel_t : public wf::txn::transaction_object_t, public wf::object_base_
         return {0, 0};
     }
 
+    /**
+     * Whether the compositor has sent a configure (for example, a new size) to the client, and the client
+     * has not yet committed a matching state.
+     */
+    bool is_configure_pending() const
+    {
+        return configure_sent_time >= 0;
+    }
+
+    /**
+     * The average time in milliseconds between the compositor sending a configure and the client committing
+     * a matching state, or 0 if no configure has been measured yet.
+     *
+     * Plugins which change the toplevel's size frequently (for example, interactive resize) can use this to
+     * avoid sending more configures than the client can handle.
+     */
+    int get_configure_latency() const
+    {
+        return configure_latency;
+    }
+
   protected:
+    /**
+     * Toplevel implementations should call this when they send a configure to the client which the client
+     * needs to respond to. A new configure replaces the previous one, so the latency is measured from it.
+     */
+    void configure_sent()
+    {
+        configure_sent_time = wf::get_current_time();
+    }
+
+    /**
+     * Toplevel implementations should call this when the client has committed a state matching the last
+     * configure.
+     */
+    void configure_acked()
+    {
+        if (configure_sent_time < 0)
+        {
+            return;
+        }
+
+        const int sample = wf::get_current_time() - configure_sent_time;
+        configure_latency   = configure_latency ? (3 * configure_latency + sample) / 4 : sample;
+        configure_sent_time = -1;
+    }
+
+    /**
+     * Toplevel implementations should call this when the state is applied, so that a configure which the
+     * client did not respond to in time (the transaction timed out) does not stay pending forever.
+     */
+    void configure_done()
+    {
+        configure_sent_time = -1;
+    }
+
+    int64_t configure_sent_time = -1;
+    int configure_latency = 0;
+
     toplevel_state_t _current;
     toplevel_state_t _pending;
     toplevel_state_t _committed;
@@ -35,6 +35,37 @@ namespace wf
 class view_access_interface_t : public access_interface_t
 {
   public:
+    /**
+     * The supported properties, as returned by intern_property().
+     */
+    enum class property_t
+    {
+        APP_ID,
+        TITLE,
+        ROLE,
+        FULLSCREEN,
+        ACTIVATED,
+        MINIMIZED,
+        FOCUSABLE,
+        MAPPED,
+        TILED_LEFT,
+        TILED_RIGHT,
+        TILED_TOP,
+        TILED_BOTTOM,
+        MAXIMIZED,
+        FLOATING,
+        TYPE,
+        UNKNOWN,
+    };
+
+    /**
+     * @brief intern_property Find the property with the given name, so that it can be queried repeatedly
+     * without comparing strings.
+     *
+     * @return The property, or property_t::UNKNOWN if it is not supported.
+     */
+    static property_t intern_property(const std::string & identifier);
+
     /**
      * @brief view_access_interface_t Default constructor.
      */
@@ -53,6 +84,11 @@ class view_access_interface_t : public access_interface_t
     // Inherits docs.
     virtual variant_t get(const std::string & identifier, bool & error) override;
 
+    /**
+     * @brief get Same as get(identifier, error), for an interned property.
+     */
+    variant_t get(property_t property, bool & error);
+
     /**
      * @brief set_view Setter for the view to interrogate.
      *
@@ -66,5 +102,10 @@ class view_access_interface_t : public access_interface_t
      * @brief _view The view to interrogate.
      */
     wayfire_view _view;
+
+    /**
+     * @brief get_type Compute the value of the "type" property.
+     */
+    std::string get_type();
 };
 } // End namespace wf.
@@ -8,6 +8,7 @@
 #include "wayfire/scene.hpp"
 #include <memory>
 #include <wayfire/render.hpp>
+#include <wayfire/util.hpp>
 
 namespace wf
 {
@@ -64,8 +65,44 @@ class transformer_base_node_t : public scene::floating_inner_node_t
     wf::texture_t get_updated_contents(const wf::geometry_t& bbox, float scale,
         std::vector<scene::render_instance_uptr>& children);
 
+    /**
+     * Parameters for rendering the children as a thumbnail, see set_thumbnail_mode().
+     */
+    struct thumbnail_mode_t
+    {
+        // The approximate fraction of its full size at which the node is displayed.
+        float display_scale = 1.0;
+        // Minimal time between two updates of @inner_content, in milliseconds.
+        // 0 means that the contents are updated on every frame, as usual.
+        int refresh_interval = 0;
+    };
+
+    /**
+     * Render the children into @inner_content at a reduced resolution. The buffer size is rounded to the
+     * nearest mip level (a power-of-two fraction of the full size) which is not smaller than the displayed
+     * size, so that small changes of the display scale (for example during animations) do not cause the
+     * buffer to be reallocated.
+     *
+     * If a refresh interval is set, damage from the children is accumulated and the buffer is repainted at
+     * most once per interval. Note that nodes which can be rendered without a copy (see
+     * zero_copy_texturable_node_t) do not use @inner_content and are unaffected.
+     *
+     * @param mode The thumbnail parameters, or std::nullopt to render at full resolution again.
+     */
+    void set_thumbnail_mode(std::optional<thumbnail_mode_t> mode);
+
+    /**
+     * Get the mip level scale (1, 1/2, 1/4, ...) to use for a node displayed at @display_scale.
+     */
+    static float get_mip_scale(float display_scale);
+
     void release_buffers();
     ~transformer_base_node_t();
+
+  private:
+    std::optional<thumbnail_mode_t> thumbnail_mode;
+    int64_t last_contents_update = 0;
+    wf::wl_timer<false> deferred_update;
 };
 
 /**
@@ -153,6 +190,12 @@ class transformer_render_instance_t : public render_instance_t
         regen_instances();
     };
 
+    // The node itself is damaged when a deferred update of its contents is due (thumbnail mode).
+    wf::signal::connection_t<node_damage_signal> on_self_damage = [=] (node_damage_signal *ev)
+    {
+        _push_damage(ev->region);
+    };
+
   public:
     transformer_render_instance_t(NodeType *self, damage_callback push_damage,
         wf::output_t *shown_on)
@@ -168,6 +211,7 @@ class transformer_render_instance_t : public render_instance_t
 
         regen_instances();
         self->connect(&on_regen_instances);
+        self->connect(&on_self_damage);
     }
 
     void regen_instances()
@@ -174,6 +174,12 @@ class view_interface_t : public wf::signal::provider_t, public wf::object_base_t
         return "";
     }
 
+    /**
+     * Get a counter which is incremented whenever the title or the app-id of the view change.
+     * It can be used to cache information derived from them, for example the result of view matchers.
+     */
+    uint64_t get_property_generation() const;
+
     /** @return true if the view has active transformers */
     bool has_transformer();
 
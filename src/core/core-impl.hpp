@@ -3,6 +3,7 @@
 
 #include <sys/resource.h>
 #include "src/core/plugin-loader.hpp"
+#include "src/core/launcher.hpp"
 #include "wayfire/core.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/scene.hpp"
@@ -92,13 +93,18 @@ class compositor_core_impl_t : public compositor_core_t
     std::vector<wayland_global_filter_t*> wayland_global_filters;
     static bool global_filter(const wl_client *client, const wl_global *global, void *data);
 
+    /**
+     * Start the given commands with the environment for clients, see compositor_core_t::run_batch().
+     */
+    std::vector<pid_t> spawn_commands(const std::vector<std::string>& commands);
+
     compositor_state_t state = compositor_state_t::UNKNOWN;
     struct rlimit user_maxfiles;
     void increase_nofile_limit();
-    void restore_nofile_limit();
 
   private:
     wf::option_wrapper_t<bool> discard_command_output;
+    std::unique_ptr<wf::process_launcher_t> launcher;
     static std::unique_ptr<compositor_core_impl_t> static_core;
 };
 
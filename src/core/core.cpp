@@ -19,7 +19,6 @@
 #include "seat/tablet.hpp"
 #include "wayfire/touch/touch.hpp"
 #include "wayfire/view.hpp"
-#include <sys/wait.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <float.h>
@@ -274,14 +273,6 @@ void wf::compositor_core_impl_t::increase_nofile_limit()
     }
 }
 
-void wf::compositor_core_impl_t::restore_nofile_limit()
-{
-    if (setrlimit(RLIMIT_NOFILE, &user_maxfiles) != 0)
-    {
-        LOGE("Failed to setrlimit(RLIMIT_NOFILE), could not restore maximum open file descriptors.");
-    }
-}
-
 void wf::compositor_core_impl_t::post_init()
 {
     discard_command_output.load_option("workarounds/discard_command_output");
@@ -368,6 +359,7 @@ void wf::compositor_core_impl_t::fini()
     tx_manager.reset();
     OpenGL::fini();
     disconnect_signals();
+    launcher.reset();
     wl_display_destroy(static_core->display);
 }
 
@@ -513,88 +505,35 @@ std::vector<wayfire_view> wf::compositor_core_t::get_all_views()
  */
 pid_t wf::compositor_core_impl_t::run(std::string command)
 {
-    static constexpr size_t READ_END  = 0;
-    static constexpr size_t WRITE_END = 1;
+    return spawn_commands({command}).front();
+}
 
-    int pipe_fd[2];
-    int ret = pipe2(pipe_fd, O_CLOEXEC);
-    if (ret == -1)
-    {
-        LOGE("wf::compositor_core_impl_t::run: failed to create pipe2: ", strerror(errno));
-        return 0;
-    }
+std::vector<pid_t> wf::compositor_core_t::run_batch(const std::vector<std::string>& commands)
+{
+    return wf::get_core_impl().spawn_commands(commands);
+}
 
-    /* The following is a "hack" for disowning the child processes,
-     * otherwise they will simply stay as zombie processes */
-    pid_t pid = fork();
-    if (!pid)
+std::vector<pid_t> wf::compositor_core_impl_t::spawn_commands(const std::vector<std::string>& commands)
+{
+    if (!launcher)
     {
-        restore_nofile_limit();
-        pid = fork();
-        if (!pid)
-        {
-            close(pipe_fd[READ_END]);
-            close(pipe_fd[WRITE_END]);
+        launcher = std::make_unique<wf::process_launcher_t>(ev_loop);
+    }
 
-            setenv("_JAVA_AWT_WM_NONREPARENTING", "1", 1);
-            setenv("WAYLAND_DISPLAY", wayland_display.c_str(), 1);
+    launch_params_t params;
+    params.env.push_back({"_JAVA_AWT_WM_NONREPARENTING", "1"});
+    params.env.push_back({"WAYLAND_DISPLAY", wayland_display});
 #if WF_HAS_XWAYLAND
-            if (!xwayland_get_display().empty())
-            {
-                setenv("DISPLAY", xwayland_get_display().c_str(), 1);
-            }
-
-#endif
-            if (discard_command_output)
-            {
-                int dev_null = open("/dev/null", O_WRONLY);
-                dup2(dev_null, 1);
-                dup2(dev_null, 2);
-                close(dev_null);
-            }
-
-            _exit(execl("/bin/sh", "/bin/sh", "-c", command.c_str(), NULL));
-        } else
-        {
-            close(pipe_fd[READ_END]);
-            int ret = write(pipe_fd[WRITE_END], (void*)(&pid), sizeof(pid));
-            close(pipe_fd[WRITE_END]);
-            _exit(ret != sizeof(pid) ? 1 : 0);
-        }
-    } else
+    if (!xwayland_get_display().empty())
     {
-        close(pipe_fd[WRITE_END]);
-
-        int status;
-        waitpid(pid, &status, 0);
-
-        // Return 0 if the child process didn't run or didn't exit normally, or returns a non-zero return
-        // value.
-        pid_t child_pid{};
-        if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
-        {
-            int ret = read(pipe_fd[READ_END], &child_pid, sizeof(child_pid));
-            if (ret != sizeof(child_pid))
-            {
-                // This is consider to be an error (even though theoretically a partial read would require an
-                // attempt to continue).
-                child_pid = 0;
-                if (ret == -1)
-                {
-                    LOGE("wf::compositor_core_impl_t::run(\"", command,
-                        "\"): failed to read PID from pipe end: ", strerror(errno));
-                } else
-                {
-                    LOGE("wf::compositor_core_impl_t::run(\"", command,
-                        "\"): short read of PID from pipe end, got ", std::to_string(ret), " bytes");
-                }
-            }
-        }
+        params.env.push_back({"DISPLAY", xwayland_get_display()});
+    }
 
-        close(pipe_fd[READ_END]);
+#endif
+    params.discard_output = discard_command_output;
+    params.nofile_limit   = user_maxfiles;
 
-        return child_pid;
-    }
+    return launcher->spawn(commands, params);
 }
 
 std::string wf::compositor_core_impl_t::get_xwayland_display()
@@ -0,0 +1,251 @@
+#include <wayfire/cost-accounting.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include <algorithm>
+
+bool wf::cost::enabled = false;
+wf::cost::owner_t wf::cost::active_owner = wf::cost::CORE;
+wf::cost::scope_t *wf::cost::scope_t::active_scope = nullptr;
+
+namespace
+{
+using namespace std::chrono;
+
+/* Statistics are kept in buckets of one second, and averaged over the last WINDOW seconds. */
+constexpr int WINDOW = 5;
+
+struct owner_data_t
+{
+    std::string name;
+    nanoseconds cpu[WINDOW][(int)wf::cost::category_t::TOTAL] = {};
+    nanoseconds gpu[WINDOW] = {};
+};
+
+struct pending_timer_t
+{
+    wlr_render_timer *timer;
+    wf::cost::owner_t owner;
+    /* The output whose frame the pass was started in */
+    wlr_output *output;
+};
+
+struct accounting_t
+{
+    std::vector<owner_data_t> owners = {owner_data_t{"core"}};
+
+    /* The second which the current bucket is for */
+    int64_t current_second = 0;
+
+    /* Timers of passes whose duration has not been read yet */
+    std::vector<pending_timer_t> pending;
+    /* The output which is currently being painted (or was painted last) */
+    wlr_output *current_output = nullptr;
+
+    int advance()
+    {
+        int64_t now = duration_cast<seconds>(steady_clock::now().time_since_epoch()).count();
+        int64_t to_clear = std::min<int64_t>(now - current_second, WINDOW);
+        for (int64_t i = 1; i <= to_clear; i++)
+        {
+            int bucket = (current_second + i) % WINDOW;
+            for (auto& owner : owners)
+            {
+                std::fill(std::begin(owner.cpu[bucket]), std::end(owner.cpu[bucket]), nanoseconds{0});
+                owner.gpu[bucket] = nanoseconds{0};
+            }
+        }
+
+        current_second = now;
+        return now % WINDOW;
+    }
+
+    void clear()
+    {
+        for (auto& owner : owners)
+        {
+            for (auto& bucket : owner.cpu)
+            {
+                std::fill(std::begin(bucket), std::end(bucket), nanoseconds{0});
+            }
+
+            std::fill(std::begin(owner.gpu), std::end(owner.gpu), nanoseconds{0});
+        }
+    }
+
+    /**
+     * Destroy the timers matching @pred, after calling @read on each of them.
+     */
+    template<class Pred, class Read>
+    void consume_timers(Pred pred, Read read)
+    {
+        auto it = std::stable_partition(pending.begin(), pending.end(),
+            [&] (const pending_timer_t& timer) { return !pred(timer); });
+        for (auto timer = it; timer != pending.end(); ++timer)
+        {
+            read(*timer);
+            wlr_render_timer_destroy(timer->timer);
+        }
+
+        pending.erase(it, pending.end());
+    }
+};
+
+accounting_t& get_accounting()
+{
+    static accounting_t accounting;
+    return accounting;
+}
+}
+
+wf::cost::owner_t wf::cost::register_owner(const std::string& name)
+{
+    auto& owners = get_accounting().owners;
+    auto it = std::find_if(owners.begin(), owners.end(), [&] (const auto& owner) { return owner.name == name; });
+    if (it != owners.end())
+    {
+        return it - owners.begin();
+    }
+
+    owners.push_back(owner_data_t{name});
+    return owners.size() - 1;
+}
+
+void wf::cost::add_cpu_time(owner_t owner, category_t category, std::chrono::nanoseconds time)
+{
+    if (!enabled)
+    {
+        return;
+    }
+
+    auto& acc  = get_accounting();
+    int bucket = acc.advance();
+    acc.owners[owner].cpu[bucket][(int)category] += time;
+}
+
+wlr_render_timer*wf::cost::create_gpu_timer(wlr_renderer *renderer)
+{
+    if (!enabled)
+    {
+        return NULL;
+    }
+
+    auto timer = wlr_render_timer_create(renderer);
+    if (timer)
+    {
+        auto& acc = get_accounting();
+        acc.pending.push_back({timer, current_owner(), acc.current_output});
+    }
+
+    return timer;
+}
+
+void wf::cost::collect_gpu_timers(wlr_output *output)
+{
+    auto& acc = get_accounting();
+    acc.current_output = output;
+    if (!enabled)
+    {
+        acc.consume_timers([] (auto&) { return true; }, [] (auto&) {});
+        return;
+    }
+
+    // The output is starting a new frame, so its previous frame has been presented and the passes started
+    // for it have finished on the GPU. Reading their timers does not stall. Passes of other outputs may
+    // still be running, so they are read when their own output starts its next frame.
+    int bucket = acc.advance();
+    acc.consume_timers([&] (const pending_timer_t& timer) { return timer.output == output; },
+        [&] (const pending_timer_t& timer)
+    {
+        int time = wlr_render_timer_get_duration_ns(timer.timer);
+        if (time >= 0)
+        {
+            acc.owners[timer.owner].gpu[bucket] += nanoseconds{time};
+        }
+    });
+}
+
+void wf::cost::forget_output(wlr_output *output)
+{
+    auto& acc = get_accounting();
+    acc.consume_timers([&] (const pending_timer_t& timer) { return timer.output == output; },
+        [] (auto&) {});
+    if (acc.current_output == output)
+    {
+        acc.current_output = nullptr;
+    }
+}
+
+std::vector<wf::cost::owner_stats_t> wf::cost::get_stats()
+{
+    auto& acc = get_accounting();
+    acc.advance();
+
+    std::vector<owner_stats_t> stats;
+    for (auto& owner : acc.owners)
+    {
+        owner_stats_t owner_stats;
+        owner_stats.name = owner.name;
+        owner_stats.gpu  = nanoseconds{0};
+        for (int c = 0; c < (int)category_t::TOTAL; c++)
+        {
+            owner_stats.cpu[c] = nanoseconds{0};
+            for (int i = 0; i < WINDOW; i++)
+            {
+                owner_stats.cpu[c] += owner.cpu[i][c];
+            }
+
+            owner_stats.cpu[c] /= WINDOW;
+        }
+
+        for (int i = 0; i < WINDOW; i++)
+        {
+            owner_stats.gpu += owner.gpu[i];
+        }
+
+        owner_stats.gpu /= WINDOW;
+        stats.push_back(owner_stats);
+    }
+
+    return stats;
+}
+
+const char *wf::cost::get_category_name(category_t category)
+{
+    switch (category)
+    {
+      case category_t::INIT:
+        return "init";
+
+      case category_t::EFFECT:
+        return "effect-hooks";
+
+      case category_t::POST:
+        return "post-hooks";
+
+      case category_t::RENDER:
+        return "render";
+
+      case category_t::SIGNAL:
+        return "signals";
+
+      case category_t::BINDING:
+        return "bindings";
+
+      case category_t::IPC:
+        return "ipc";
+
+      default:
+        return "unknown";
+    }
+}
+
+void wf::cost::set_enabled(bool enabled)
+{
+    if (enabled && !wf::cost::enabled)
+    {
+        auto& acc = get_accounting();
+        acc.clear();
+        acc.advance();
+    }
+
+    wf::cost::enabled = enabled;
+}
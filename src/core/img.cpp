@@ -19,6 +19,11 @@
 #include <cstdio>
 #include <unordered_map>
 #include <functional>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <sys/eventfd.h>
 
 #define TEXTURE_LOAD_ERROR 0
 
@@ -233,13 +238,13 @@ bool texture_from_png(const char *filename, GLuint target)
     return true;
 }
 
-void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert)
+bool texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert)
 {
     png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr,
         nullptr, nullptr);
     if (!png)
     {
-        return;
+        return false;
     }
 
     png_infop infot = png_create_info_struct(png);
@@ -247,7 +252,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     {
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     FILE *fp = fopen(name, "wb");
@@ -255,7 +260,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     {
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     png_init_io(png, fp);
@@ -269,7 +274,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
         fclose(fp);
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     png_set_PLTE(png, infot, palette, PNG_MAX_PALETTE_LENGTH);
@@ -295,6 +300,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
 
     fclose(fp);
     png_free(png, rows);
+    return true;
 }
 
 bool texture_from_jpeg(const char *FileName, GLuint target)
@@ -430,6 +436,370 @@ void write_to_file(std::string name, const wf::render_buffer_t& fb)
     wlr_texture_destroy(tex);
 }
 
+std::optional<image_format_t> parse_image_format(const std::string& name)
+{
+    if (name == "png")
+    {
+        return image_format_t::PNG;
+    } else if (name == "qoi")
+    {
+        return image_format_t::QOI;
+    } else if ((name == "raw") || (name == "pam"))
+    {
+        return image_format_t::PAM;
+    }
+
+    return {};
+}
+
+namespace
+{
+/**
+ * Encode the pixels (RGBA, top-down) in the QOI format, see https://qoiformat.org/qoi-specification.pdf
+ */
+bool write_qoi(const char *name, const uint8_t *pixels, uint32_t w, uint32_t h)
+{
+    std::vector<uint8_t> out;
+    out.reserve(14 + (size_t)w * h * 2 + 8);
+    const auto& put32 = [&] (uint32_t value)
+    {
+        out.push_back(value >> 24);
+        out.push_back(value >> 16);
+        out.push_back(value >> 8);
+        out.push_back(value);
+    };
+
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    put32(w);
+    put32(h);
+    out.push_back(4); // channels
+    out.push_back(0); // sRGB with linear alpha
+
+    uint8_t index[64][4] = {};
+    uint8_t prev[4] = {0, 0, 0, 255};
+    int run = 0;
+
+    const size_t nr_pixels = (size_t)w * h;
+    for (size_t i = 0; i < nr_pixels; i++)
+    {
+        const uint8_t *px = pixels + i * 4;
+        if (!memcmp(px, prev, 4))
+        {
+            ++run;
+            if ((run == 62) || (i == nr_pixels - 1))
+            {
+                out.push_back(0xc0 | (run - 1));
+                run = 0;
+            }
+
+            continue;
+        }
+
+        if (run > 0)
+        {
+            out.push_back(0xc0 | (run - 1));
+            run = 0;
+        }
+
+        const int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if (!memcmp(index[hash], px, 4))
+        {
+            out.push_back(hash);
+        } else
+        {
+            memcpy(index[hash], px, 4);
+            if (px[3] == prev[3])
+            {
+                const int8_t vr   = px[0] - prev[0];
+                const int8_t vg   = px[1] - prev[1];
+                const int8_t vb   = px[2] - prev[2];
+                const int8_t vg_r = vr - vg;
+                const int8_t vg_b = vb - vg;
+
+                if ((vr > -3) && (vr < 2) && (vg > -3) && (vg < 2) && (vb > -3) && (vb < 2))
+                {
+                    out.push_back(0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+                } else if ((vg_r > -9) && (vg_r < 8) && (vg > -33) && (vg < 32) && (vg_b > -9) && (vg_b < 8))
+                {
+                    out.push_back(0x80 | (vg + 32));
+                    out.push_back(((vg_r + 8) << 4) | (vg_b + 8));
+                } else
+                {
+                    out.insert(out.end(), {0xfe, px[0], px[1], px[2]});
+                }
+            } else
+            {
+                out.insert(out.end(), {0xff, px[0], px[1], px[2], px[3]});
+            }
+        }
+
+        memcpy(prev, px, 4);
+    }
+
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+
+    FILE *fp = fopen(name, "wb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    const bool ok = fwrite(out.data(), 1, out.size(), fp) == out.size();
+    return (fclose(fp) == 0) && ok;
+}
+
+/**
+ * Write the pixels (RGBA, top-down) without compression, as a Netpbm PAM image.
+ */
+bool write_pam(const char *name, const uint8_t *pixels, uint32_t w, uint32_t h)
+{
+    FILE *fp = fopen(name, "wb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    fprintf(fp, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", w, h);
+    const size_t size = (size_t)w * h * 4;
+    const bool ok     = fwrite(pixels, 1, size, fp) == size;
+    return (fclose(fp) == 0) && ok;
+}
+
+bool encode_image(const char *name, const uint8_t *pixels, uint32_t w, uint32_t h, image_format_t format)
+{
+    switch (format)
+    {
+      case image_format_t::PNG:
+#ifdef BUILD_WITH_IMAGEIO
+        return texture_to_png(name, (uint8_t*)pixels, w, h, false);
+#else
+        LOGE("Cannot write ", name, ": wayfire was built without PNG support");
+        return false;
+#endif
+
+      case image_format_t::QOI:
+        return write_qoi(name, pixels, w, h);
+
+      case image_format_t::PAM:
+        return write_pam(name, pixels, w, h);
+    }
+
+    return false;
+}
+
+/**
+ * Encodes images in a background thread.
+ *
+ * Pixels are read back on the main thread into staging buffers which are reused across captures, and then
+ * handed to the worker. Once a file has been written, the worker notifies the main loop via an eventfd and
+ * the completion callback is run there.
+ */
+class image_writer_t
+{
+  public:
+    static image_writer_t& get()
+    {
+        static image_writer_t writer;
+        return writer;
+    }
+
+    std::vector<uint8_t> acquire_staging_buffer(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = staging_pool.begin(); it != staging_pool.end(); ++it)
+        {
+            if (it->capacity() >= size)
+            {
+                auto buffer = std::move(*it);
+                staging_pool.erase(it);
+                buffer.resize(size);
+                return buffer;
+            }
+        }
+
+        return std::vector<uint8_t>(size);
+    }
+
+    void submit(std::string name, std::vector<uint8_t> pixels, uint32_t w, uint32_t h,
+        image_format_t format, std::function<void(bool)> on_done)
+    {
+        ensure_started();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(job_t{std::move(name), std::move(pixels), w, h, format, std::move(on_done), false});
+        cond.notify_one();
+    }
+
+    ~image_writer_t()
+    {
+        if (worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+                cond.notify_one();
+            }
+
+            worker.join();
+        }
+
+        // The event loop is already gone at this point, so we only close the fd.
+        if (done_fd >= 0)
+        {
+            close(done_fd);
+        }
+    }
+
+  private:
+    struct job_t
+    {
+        std::string name;
+        std::vector<uint8_t> pixels;
+        uint32_t width;
+        uint32_t height;
+        image_format_t format;
+        std::function<void(bool)> on_done;
+        bool success;
+    };
+
+    /* Keep at most this many staging buffers around for the next captures. */
+    static constexpr size_t MAX_POOLED_BUFFERS = 2;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<job_t> pending;
+    std::deque<job_t> finished;
+    std::vector<std::vector<uint8_t>> staging_pool;
+    bool stopping = false;
+
+    std::thread worker;
+    int done_fd = -1;
+    wl_event_source *done_source = NULL;
+
+    void ensure_started()
+    {
+        if (worker.joinable())
+        {
+            return;
+        }
+
+        done_fd     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        done_source = wl_event_loop_add_fd(wf::get_core().ev_loop, done_fd, WL_EVENT_READABLE,
+            [] (int, uint32_t, void *data)
+        {
+            ((image_writer_t*)data)->dispatch_finished();
+            return 0;
+        }, this);
+
+        worker = std::thread([this] () { run_worker(); });
+    }
+
+    void run_worker()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cond.wait(lock, [&] { return stopping || !pending.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+
+            auto job = std::move(pending.front());
+            pending.pop_front();
+
+            lock.unlock();
+            job.success = encode_image(job.name.c_str(), job.pixels.data(), job.width, job.height,
+                job.format);
+            lock.lock();
+
+            if (staging_pool.size() < MAX_POOLED_BUFFERS)
+            {
+                staging_pool.push_back(std::move(job.pixels));
+            }
+
+            job.pixels = {};
+            finished.push_back(std::move(job));
+
+            uint64_t one = 1;
+            if (write(done_fd, &one, sizeof(one)) < 0)
+            {
+                LOGE("Failed to notify the main loop about a finished image!");
+            }
+        }
+    }
+
+    void dispatch_finished()
+    {
+        uint64_t count;
+        if (read(done_fd, &count, sizeof(count)) < 0)
+        {
+            return;
+        }
+
+        std::deque<job_t> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(done, finished);
+        }
+
+        for (auto& job : done)
+        {
+            if (!job.success)
+            {
+                LOGE("Failed to write image ", job.name);
+            }
+
+            if (job.on_done)
+            {
+                job.on_done(job.success);
+            }
+        }
+    }
+};
+}
+
+void write_to_file_async(std::string name, const wf::render_buffer_t& fb, image_format_t format,
+    std::function<void(bool)> on_done)
+{
+    auto tex = wlr_texture_from_buffer(wf::get_core().renderer, fb.get_buffer());
+    if (!tex)
+    {
+        LOGE("failed to create texture for reading back ", name);
+        if (on_done)
+        {
+            on_done(false);
+        }
+
+        return;
+    }
+
+    auto& writer = image_writer_t::get();
+    auto pixels  = writer.acquire_staging_buffer((size_t)tex->width * tex->height * 4);
+
+    wlr_texture_read_pixels_options opts{};
+    opts.data   = pixels.data();
+    opts.format = DRM_FORMAT_ABGR8888;
+    opts.stride = tex->width * 4;
+    const bool read_ok = wlr_texture_read_pixels(tex, &opts);
+    const uint32_t width  = tex->width;
+    const uint32_t height = tex->height;
+    wlr_texture_destroy(tex);
+
+    if (!read_ok)
+    {
+        LOGE("failed to read pixels from texture");
+        if (on_done)
+        {
+            on_done(false);
+        }
+
+        return;
+    }
+
+    writer.submit(std::move(name), std::move(pixels), width, height, format, std::move(on_done));
+}
+
 void init()
 {
     LOGD("init ImageIO");
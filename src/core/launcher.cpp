@@ -0,0 +1,243 @@
+#include "launcher.hpp"
+#include <wayfire/util/log.hpp>
+#include <algorithm>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+/* Reaping interval for children without a pidfd */
+static constexpr uint32_t REAP_INTERVAL_MS = 1000;
+
+wf::process_launcher_t::process_launcher_t(wl_event_loop *loop) : loop(loop)
+{}
+
+wf::process_launcher_t::~process_launcher_t()
+{
+    if (reap_timer)
+    {
+        wl_event_source_remove(reap_timer);
+    }
+
+    // Processes which are still running are reparented to init when the compositor exits.
+    for (auto& [pid, child] : children)
+    {
+        if (child.source)
+        {
+            wl_event_source_remove(child.source);
+        }
+
+        if (child.pidfd >= 0)
+        {
+            close(child.pidfd);
+        }
+    }
+}
+
+static std::vector<std::string> build_environment(const wf::launch_params_t& params)
+{
+    std::vector<std::string> env;
+    for (char **var = environ; *var; ++var)
+    {
+        std::string_view entry{*var};
+        auto name = entry.substr(0, entry.find('='));
+        bool overridden = std::any_of(params.env.begin(), params.env.end(),
+            [&] (const auto& pair) { return pair.first == name; });
+        if (!overridden)
+        {
+            env.emplace_back(entry);
+        }
+    }
+
+    for (const auto& [name, value] : params.env)
+    {
+        env.push_back(name + "=" + value);
+    }
+
+    return env;
+}
+
+std::vector<pid_t> wf::process_launcher_t::spawn(const std::vector<std::string>& commands,
+    const launch_params_t& params)
+{
+    // The child of vfork() shares the memory of the compositor and may only make system calls until it
+    // execs, so everything it needs is prepared upfront.
+    auto env_storage = build_environment(params);
+    std::vector<char*> envp;
+    for (auto& var : env_storage)
+    {
+        envp.push_back(var.data());
+    }
+
+    envp.push_back(nullptr);
+
+    int dev_null = -1;
+    if (params.discard_output)
+    {
+        dev_null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    }
+
+    const rlimit *nofile_limit = params.nofile_limit ? &params.nofile_limit.value() : nullptr;
+
+    // Block signals while the child runs on our stack, so that none of the compositor's handlers run in it.
+    sigset_t all_signals, old_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &old_signals);
+
+    std::vector<pid_t> pids;
+    for (const auto& command : commands)
+    {
+        char *const argv[] = {(char*)"/bin/sh", (char*)"-c", (char*)command.c_str(), NULL};
+        pid_t pid = vfork();
+        if (pid == 0)
+        {
+            for (int sig = 1; sig < NSIG; sig++)
+            {
+                struct sigaction action;
+                if ((sigaction(sig, NULL, &action) == 0) &&
+                    (action.sa_handler != SIG_DFL) && (action.sa_handler != SIG_IGN))
+                {
+                    action.sa_handler = SIG_DFL;
+                    sigaction(sig, &action, NULL);
+                }
+            }
+
+            sigprocmask(SIG_SETMASK, &old_signals, NULL);
+            if (nofile_limit)
+            {
+                setrlimit(RLIMIT_NOFILE, nofile_limit);
+            }
+
+            if (dev_null >= 0)
+            {
+                dup2(dev_null, 1);
+                dup2(dev_null, 2);
+            }
+
+            execve("/bin/sh", argv, envp.data());
+            _exit(127);
+        }
+
+        if (pid < 0)
+        {
+            LOGE("Failed to start \"", command, "\": ", strerror(errno));
+            pids.push_back(0);
+            continue;
+        }
+
+        pids.push_back(pid);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+    if (dev_null >= 0)
+    {
+        close(dev_null);
+    }
+
+    for (auto pid : pids)
+    {
+        if (pid > 0)
+        {
+            watch_child(pid);
+        }
+    }
+
+    return pids;
+}
+
+void wf::process_launcher_t::watch_child(pid_t pid)
+{
+    child_t child;
+#ifdef SYS_pidfd_open
+    child.pidfd = syscall(SYS_pidfd_open, pid, 0);
+#endif
+    if (child.pidfd >= 0)
+    {
+        // The pidfd becomes readable when the process exits.
+        child.source = wl_event_loop_add_fd(loop, child.pidfd, WL_EVENT_READABLE,
+            [] (int fd, uint32_t, void *data)
+        {
+            auto self = (process_launcher_t*)data;
+            auto it   = std::find_if(self->children.begin(), self->children.end(),
+                [&] (const auto& entry) { return entry.second.pidfd == fd; });
+            if (it != self->children.end())
+            {
+                self->reap(it->first);
+            }
+
+            return 0;
+        }, this);
+    }
+
+    children[pid] = child;
+    if ((child.pidfd < 0) && !reap_timer)
+    {
+        reap_timer = wl_event_loop_add_timer(loop, [] (void *data)
+        {
+            auto self = (process_launcher_t*)data;
+            if (self->reap_exited())
+            {
+                wl_event_source_timer_update(self->reap_timer, REAP_INTERVAL_MS);
+            } else
+            {
+                wl_event_source_remove(self->reap_timer);
+                self->reap_timer = NULL;
+            }
+
+            return 0;
+        }, this);
+        wl_event_source_timer_update(reap_timer, REAP_INTERVAL_MS);
+    }
+}
+
+size_t wf::process_launcher_t::count_running() const
+{
+    return children.size();
+}
+
+void wf::process_launcher_t::reap(pid_t pid)
+{
+    int status;
+    if (waitpid(pid, &status, WNOHANG) == 0)
+    {
+        return;
+    }
+
+    auto& child = children[pid];
+    if (child.source)
+    {
+        wl_event_source_remove(child.source);
+    }
+
+    if (child.pidfd >= 0)
+    {
+        close(child.pidfd);
+    }
+
+    children.erase(pid);
+}
+
+bool wf::process_launcher_t::reap_exited()
+{
+    std::vector<pid_t> polled;
+    for (auto& [pid, child] : children)
+    {
+        if (child.pidfd < 0)
+        {
+            polled.push_back(pid);
+        }
+    }
+
+    for (auto pid : polled)
+    {
+        reap(pid);
+    }
+
+    return std::any_of(children.begin(), children.end(),
+        [] (const auto& entry) { return entry.second.pidfd < 0; });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <wayland-server.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wf
+{
+/**
+ * Parameters for starting processes with process_launcher_t.
+ */
+struct launch_params_t
+{
+    /* Variables to set in the environment of the new processes, in addition to the compositor's own. */
+    std::vector<std::pair<std::string, std::string>> env;
+    /* Redirect stdout and stderr of the new processes to /dev/null */
+    bool discard_output = false;
+    /* The limit on open files for the new processes, if it should differ from the compositor's. */
+    std::optional<rlimit> nofile_limit;
+};
+
+/**
+ * Starts shell commands on behalf of the compositor.
+ *
+ * Processes are started with vfork() + exec(), so the (large) address space of the compositor is never
+ * copied and the PID is known as soon as the call returns. The started processes are children of the
+ * compositor, which reaps them from the event loop once they exit.
+ */
+class process_launcher_t
+{
+  public:
+    /**
+     * @param loop The event loop from which exited processes are reaped.
+     */
+    process_launcher_t(wl_event_loop *loop);
+    ~process_launcher_t();
+
+    process_launcher_t(const process_launcher_t&) = delete;
+    process_launcher_t(process_launcher_t&&) = delete;
+    process_launcher_t& operator =(const process_launcher_t&) = delete;
+    process_launcher_t& operator =(process_launcher_t&&) = delete;
+
+    /**
+     * Run each of the given commands with /bin/sh -c.
+     *
+     * @return The PIDs of the started processes, in the same order as @commands. The PID is 0 for
+     *   commands which could not be started.
+     */
+    std::vector<pid_t> spawn(const std::vector<std::string>& commands, const launch_params_t& params);
+
+    /**
+     * @return The number of started processes which have not been reaped yet.
+     */
+    size_t count_running() const;
+
+  private:
+    struct child_t
+    {
+        int pidfd = -1;
+        wl_event_source *source = NULL;
+    };
+
+    wl_event_loop *loop;
+    std::map<pid_t, child_t> children;
+    /* Used to reap children when pidfds are not supported by the kernel. */
+    wl_event_source *reap_timer = NULL;
+
+    void watch_child(pid_t pid);
+    void reap(pid_t pid);
+    bool reap_exited();
+};
+}
@@ -5,6 +5,65 @@
 #include <wayfire/condition/condition.hpp>
 #include <wayfire/view-access-interface.hpp>
 #include <wayfire/parser/condition_parser.hpp>
+#include <unordered_map>
+
+namespace
+{
+using property_t = wf::view_access_interface_t::property_t;
+
+struct property_read_t
+{
+    property_t property;
+    wf::variant_t value;
+    bool error;
+};
+
+/**
+ * Provides the view properties to a condition. Each property is read from the view at most once per
+ * evaluation, and all reads are recorded, so that the result of the evaluation can be reused later.
+ */
+class recording_access_interface_t : public wf::access_interface_t
+{
+  public:
+    recording_access_interface_t(wayfire_view view) : view_access(view)
+    {}
+
+    wf::variant_t get(const std::string& identifier, bool& error) override
+    {
+        auto property = wf::view_access_interface_t::intern_property(identifier);
+        if (property == property_t::UNKNOWN)
+        {
+            return view_access.get(identifier, error);
+        }
+
+        for (const auto& read : reads)
+        {
+            if (read.property == property)
+            {
+                error = read.error;
+                return read.value;
+            }
+        }
+
+        auto value = view_access.get(property, error);
+        reads.push_back({property, value, error});
+        return value;
+    }
+
+    wf::view_access_interface_t view_access;
+    std::vector<property_read_t> reads;
+};
+
+/**
+ * Properties which are covered by view_interface_t::get_property_generation().
+ * The rest of the properties are cheap to read, but can change without notice, so their values are
+ * compared instead.
+ */
+bool is_tracked_by_generation(property_t property)
+{
+    return (property == property_t::APP_ID) || (property == property_t::TITLE);
+}
+}
 
 class wf::view_matcher_t::impl
 {
@@ -15,6 +74,87 @@ class wf::view_matcher_t::impl
     wf::condition_parser_t parser;
     std::shared_ptr<wf::condition_t> condition;
 
+    /**
+     * The last result of the condition for a view, which stays valid as long as the view's property
+     * generation and the values of the other properties read by the condition do not change.
+     */
+    struct memo_t
+    {
+        uint64_t generation;
+        bool result;
+        std::vector<property_read_t> untracked_reads;
+    };
+
+    /* Keyed by view id. Entries are removed when their view is destroyed. */
+    std::unordered_map<uint32_t, memo_t> memo;
+
+    wf::signal::connection_t<wf::destruct_signal<wf::view_interface_t>> on_view_destruct =
+        [=] (wf::destruct_signal<wf::view_interface_t> *ev)
+    {
+        memo.erase(ev->object->get_id());
+    };
+
+    void clear_memo()
+    {
+        memo.clear();
+        on_view_destruct.disconnect();
+    }
+
+    bool is_memo_valid(wayfire_view view, const memo_t& entry)
+    {
+        if (entry.generation != view->get_property_generation())
+        {
+            return false;
+        }
+
+        wf::view_access_interface_t access{view};
+        for (const auto& read : entry.untracked_reads)
+        {
+            bool error;
+            if (access.get(read.property, error) != read.value)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool evaluate(wayfire_view view)
+    {
+        auto it = memo.find(view->get_id());
+        if ((it != memo.end()) && is_memo_valid(view, it->second))
+        {
+            return it->second.result;
+        }
+
+        bool ignored = false;
+        recording_access_interface_t access_interface{view};
+        const bool result = condition->evaluate(access_interface, ignored);
+
+        memo_t entry;
+        entry.generation = view->get_property_generation();
+        entry.result     = result;
+        for (auto& read : access_interface.reads)
+        {
+            if (!is_tracked_by_generation(read.property))
+            {
+                entry.untracked_reads.push_back(std::move(read));
+            }
+        }
+
+        if (it == memo.end())
+        {
+            view->connect(&on_view_destruct);
+            memo.emplace(view->get_id(), std::move(entry));
+        } else
+        {
+            it->second = std::move(entry);
+        }
+
+        return result;
+    }
+
     bool try_parse(const std::string& value, const std::string& opt_name)
     {
         lexer.reset(value);
@@ -34,6 +174,7 @@ class wf::view_matcher_t::impl
 
     wf::config::option_base_t::updated_callback_t update_condition = [=] ()
     {
+        clear_memo();
         if (!try_parse(option->get_value(), option->get_name()))
         {
             if (option->get_value() != option->get_default_value())
@@ -110,15 +251,19 @@ void wf::view_matcher_t::set_from_option(
 
 bool wf::view_matcher_t::matches(wayfire_view view)
 {
-    if (this->priv->condition)
+    if (!this->priv->condition)
+    {
+        return false;
+    }
+
+    if (!view)
     {
         bool ignored = false;
         wf::view_access_interface_t access_interface{view};
-
         return this->priv->condition->evaluate(access_interface, ignored);
     }
 
-    return false;
+    return this->priv->evaluate(view);
 }
 
 wf::view_matcher_t::~view_matcher_t() = default;
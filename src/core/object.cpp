@@ -1,5 +1,6 @@
 #include "wayfire/object.hpp"
 #include <unordered_map>
+#include <typeindex>
 #include <wayfire/signal-provider.hpp>
 #include <wayfire/nonstd/safe-list.hpp>
 #include <wayfire/util/log.hpp>
@@ -32,12 +33,20 @@ void wf::signal::provider_t::connect_base(std::type_index idx, connection_base_t
 {
     priv->typed_connections[idx].push_back(callback);
     callback->connected_to.push_back(this);
+    if (wf::cost::current_owner() != wf::cost::CORE)
+    {
+        callback->cost_owner = wf::cost::current_owner();
+    }
 }
 
 void wf::signal::provider_t::for_each_connection(
     std::type_index type, std::function<void(connection_base_t*)> func)
 {
-    priv->typed_connections[type].for_each(func);
+    priv->typed_connections[type].for_each([&] (connection_base_t *connection)
+    {
+        wf::cost::scope_t scope{connection->cost_owner, wf::cost::category_t::SIGNAL};
+        func(connection);
+    });
 }
 
 void wf::signal::connection_base_t::disconnect()
@@ -63,6 +72,48 @@ class wf::object_base_t::obase_impl
   public:
     std::unordered_map<std::string, std::unique_ptr<custom_data_t>> data;
     uint32_t object_id;
+
+    /* Data stored by type. Objects usually carry only a few kinds of data, so the first few are kept in a
+     * small array which is searched linearly. Slot 0 marks an unused entry. */
+    static constexpr size_t INLINE_SLOTS = 8;
+    std::pair<uint32_t, std::unique_ptr<custom_data_t>> inline_typed[INLINE_SLOTS];
+    std::unordered_map<uint32_t, std::unique_ptr<custom_data_t>> overflow_typed;
+
+    std::unique_ptr<custom_data_t> *find_typed(uint32_t slot)
+    {
+        for (auto& [id, data] : inline_typed)
+        {
+            if (id == slot)
+            {
+                return &data;
+            }
+        }
+
+        auto it = overflow_typed.find(slot);
+        return (it == overflow_typed.end()) ? nullptr : &it->second;
+    }
+
+    std::unique_ptr<custom_data_t> take_typed(uint32_t slot)
+    {
+        for (auto& [id, data] : inline_typed)
+        {
+            if (id == slot)
+            {
+                id = 0;
+                return std::move(data);
+            }
+        }
+
+        auto it = overflow_typed.find(slot);
+        if (it == overflow_typed.end())
+        {
+            return nullptr;
+        }
+
+        auto data = std::move(it->second);
+        overflow_typed.erase(it);
+        return data;
+    }
 };
 
 wf::object_base_t::object_base_t()
@@ -85,6 +136,23 @@ uint32_t wf::object_base_t::get_id() const
     return obase_priv->object_id;
 }
 
+/**
+ * The slots of the types used with the typed accessors, by typeid(T).name(). Plugins which still access such
+ * data by its type name (the default key before the typed accessors existed) are redirected to the slot, so
+ * that both kinds of access see the same data.
+ */
+static std::unordered_map<std::string, uint32_t>& type_slots_by_name()
+{
+    static std::unordered_map<std::string, uint32_t> slots;
+    return slots;
+}
+
+static uint32_t find_type_slot(const std::string& name)
+{
+    auto it = type_slots_by_name().find(name);
+    return (it == type_slots_by_name().end()) ? 0 : it->second;
+}
+
 bool wf::object_base_t::has_data(std::string name)
 {
     return _fetch_data(name) != nullptr;
@@ -92,7 +160,12 @@ bool wf::object_base_t::has_data(std::string name)
 
 void wf::object_base_t::erase_data(std::string name)
 {
-    if (!has_data(name))
+    if (uint32_t slot = find_type_slot(name))
+    {
+        _erase_typed(slot);
+    }
+
+    if (obase_priv->data.count(name) == 0)
     {
         return;
     }
@@ -104,17 +177,23 @@ void wf::object_base_t::erase_data(std::string name)
 
 wf::custom_data_t*wf::object_base_t::_fetch_data(std::string name)
 {
-    auto it = obase_priv->data.find(name);
-    if (it == obase_priv->data.end())
+    uint32_t slot = find_type_slot(name);
+    if (auto data = slot ? _fetch_typed(slot) : nullptr)
     {
-        return nullptr;
+        return data;
     }
 
-    return it->second.get();
+    auto it = obase_priv->data.find(name);
+    return (it == obase_priv->data.end()) ? nullptr : it->second.get();
 }
 
 wf::custom_data_t*wf::object_base_t::_fetch_erase(std::string name)
 {
+    if (uint32_t slot = find_type_slot(name); slot && _fetch_typed(slot))
+    {
+        return _release_typed(slot);
+    }
+
     auto data = obase_priv->data[name].release();
     erase_data(name);
 
@@ -124,9 +203,63 @@ wf::custom_data_t*wf::object_base_t::_fetch_erase(std::string name)
 void wf::object_base_t::_store_data(std::unique_ptr<wf::custom_data_t> data,
     std::string name)
 {
+    if (uint32_t slot = find_type_slot(name))
+    {
+        _store_typed(slot, std::move(data));
+        return;
+    }
+
     obase_priv->data[name] = std::move(data);
 }
 
+uint32_t wf::object_base_t::_allocate_type_slot(const std::type_info& type)
+{
+    static std::unordered_map<std::type_index, uint32_t> slots;
+    // Slot 0 is reserved for unused entries
+    uint32_t slot = slots.try_emplace(type, slots.size() + 1).first->second;
+    type_slots_by_name().try_emplace(type.name(), slot);
+    return slot;
+}
+
+wf::custom_data_t*wf::object_base_t::_fetch_typed(uint32_t slot)
+{
+    auto data = obase_priv->find_typed(slot);
+    return data ? data->get() : nullptr;
+}
+
+void wf::object_base_t::_store_typed(uint32_t slot, std::unique_ptr<custom_data_t> data)
+{
+    if (auto existing = obase_priv->find_typed(slot))
+    {
+        *existing = std::move(data);
+        return;
+    }
+
+    for (auto& [id, entry] : obase_priv->inline_typed)
+    {
+        if (id == 0)
+        {
+            id    = slot;
+            entry = std::move(data);
+            return;
+        }
+    }
+
+    obase_priv->overflow_typed[slot] = std::move(data);
+}
+
+void wf::object_base_t::_erase_typed(uint32_t slot)
+{
+    // The data is destroyed after it has been removed, in case its destructor accesses the object.
+    auto data = obase_priv->take_typed(slot);
+    data.reset();
+}
+
+wf::custom_data_t*wf::object_base_t::_release_typed(uint32_t slot)
+{
+    return obase_priv->take_typed(slot).release();
+}
+
 void wf::object_base_t::_clear_data()
 {
     std::vector<std::string> keys;
@@ -139,6 +272,25 @@ void wf::object_base_t::_clear_data()
     {
         erase_data(key);
     }
+
+    std::vector<uint32_t> slots;
+    for (auto const& [id, data] : obase_priv->inline_typed)
+    {
+        if (id != 0)
+        {
+            slots.push_back(id);
+        }
+    }
+
+    for (auto const& [id, data] : obase_priv->overflow_typed)
+    {
+        slots.push_back(id);
+    }
+
+    for (auto slot : slots)
+    {
+        _erase_typed(slot);
+    }
 }
 
 void wf::object_base_t::_warn_wrong_type(std::string name)
@@ -53,8 +53,11 @@ wf::plugin_manager_t::~plugin_manager_t()
 void wf::plugin_manager_t::destroy_plugin(wf::loaded_plugin_t& p)
 {
     LOGD("Unloading plugin ", p.so_path);
-    p.instance->fini();
-    p.instance.reset();
+    {
+        wf::cost::scope_t scope{p.cost_owner, wf::cost::category_t::INIT};
+        p.instance->fini();
+        p.instance.reset();
+    }
 
     /* dlopen()/dlclose() do reference counting, so we should close the plugin
      * as many times as we opened it.
@@ -157,7 +160,9 @@ std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(s
         auto new_instance_func = union_cast<void*, wayfire_plugin_load_func>(new_instance_func_ptr);
 
         loaded_plugin_t lp;
+        lp.cost_owner = wf::cost::register_owner(get_plugin_name_from_path(path));
         try {
+            wf::cost::scope_t scope{lp.cost_owner, wf::cost::category_t::INIT};
             lp.instance  = std::unique_ptr<wf::plugin_interface_t>(new_instance_func());
             lp.so_handle = handle;
             lp.so_path   = path;
@@ -264,7 +269,11 @@ void wf::plugin_manager_t::reload_dynamic_plugins()
     for (auto& [plugin, ptr] : pending_initialize)
     {
         try {
-            ptr.instance->init();
+            {
+                wf::cost::scope_t scope{ptr.cost_owner, wf::cost::category_t::INIT};
+                ptr.instance->init();
+            }
+
             loaded_plugins[plugin] = std::move(ptr);
         } catch (...)
         {
@@ -281,6 +290,8 @@ template<class T>
 static wf::loaded_plugin_t create_plugin(std::string name)
 {
     wf::loaded_plugin_t lp;
+    lp.cost_owner = wf::cost::register_owner(name);
+    wf::cost::scope_t scope{lp.cost_owner, wf::cost::category_t::INIT};
     lp.instance  = std::make_unique<T>();
     lp.so_handle = nullptr;
     lp.so_path   = name;
@@ -350,3 +361,14 @@ std::optional<std::string> wf::get_plugin_path_for_name(
 
     return {};
 }
+
+std::string wf::get_plugin_name_from_path(const std::string& path)
+{
+    std::string name = std::filesystem::path(path).stem();
+    if (name.rfind("lib", 0) == 0)
+    {
+        name = name.substr(3);
+    }
+
+    return name;
+}
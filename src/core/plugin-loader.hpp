@@ -5,6 +5,7 @@
 #include "wayfire/plugin.hpp"
 #include "wayfire/util.hpp"
 #include <wayfire/option-wrapper.hpp>
+#include <wayfire/cost-accounting.hpp>
 
 namespace wf
 {
@@ -18,6 +19,9 @@ struct loaded_plugin_t
 
     // A path to the .so file of the plugin.
     std::string so_path;
+
+    // The owner to which time spent in the plugin is attributed.
+    wf::cost::owner_t cost_owner = wf::cost::CORE;
 };
 
 struct plugin_manager_t
@@ -85,4 +89,9 @@ std::vector<std::string> get_plugin_paths();
  */
 std::optional<std::string> get_plugin_path_for_name(
     std::vector<std::string> plugin_paths, std::string plugin_name);
+
+/**
+ * Get the name of a plugin from the path to its .so file, i.e the inverse of get_plugin_path_for_name().
+ */
+std::string get_plugin_name_from_path(const std::string& path);
 }
@@ -248,6 +248,8 @@ void node_t::gen_render_instances(std::vector<render_instance_uptr> & instances,
     {
         if (ch->is_enabled())
         {
+            // Instances inherit the owner of the node they are generated for
+            wf::cost::scope_t scope{ch->cost_owner, wf::cost::category_t::RENDER};
             ch->gen_render_instances(instances, push_damage, output);
         }
     }
@@ -413,6 +415,7 @@ class output_render_instance_t : public default_render_instance_t
         {
             if (child->is_enabled())
             {
+                wf::cost::scope_t scope{child->cost_owner, wf::cost::category_t::RENDER};
                 child->gen_render_instances(children,
                     transform_damage(callback), shown_on);
             }
@@ -702,6 +705,7 @@ void render_instance_manager_t::regen_instances()
     instances.clear();
     for (auto& node : nodes)
     {
+        wf::cost::scope_t scope{node->cost_owner, wf::cost::category_t::RENDER};
         node->gen_render_instances(instances, on_damage, reference_output);
     }
 }
@@ -62,8 +62,10 @@ bool wf::bindings_repository_t::handle_key(const wf::keybinding_t& pressed,
             /* We must be careful because the callback might be erased,
              * so force copy the callback into the lambda */
             auto callback = binding->callback;
-            callbacks.emplace_back([pressed, callback] ()
+            auto owner    = binding->owner;
+            callbacks.emplace_back([pressed, callback, owner] ()
             {
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 return (*callback)(pressed);
             });
         }
@@ -76,7 +78,8 @@ bool wf::bindings_repository_t::handle_key(const wf::keybinding_t& pressed,
             /* We must be careful because the callback might be erased,
              * so force copy the callback into the lambda */
             auto callback = binding->callback;
-            callbacks.emplace_back([pressed, callback, mod_binding_key] ()
+            auto owner    = binding->owner;
+            callbacks.emplace_back([pressed, callback, owner, mod_binding_key] ()
             {
                 wf::activator_data_t ev = {
                     .source = activator_source_t::KEYBINDING,
@@ -89,6 +92,7 @@ bool wf::bindings_repository_t::handle_key(const wf::keybinding_t& pressed,
                     ev.activation_data = mod_binding_key;
                 }
 
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 return (*callback)(ev);
             });
         }
@@ -111,18 +115,19 @@ bool wf::bindings_repository_t::handle_axis(uint32_t modifiers,
         return false;
     }
 
-    std::vector<wf::axis_callback*> callbacks;
+    std::vector<std::pair<wf::axis_callback*, wf::cost::owner_t>> callbacks;
 
     for (auto& binding : this->priv->axes)
     {
         if (binding->activated_by->get_value() == wf::keybinding_t{modifiers, 0})
         {
-            callbacks.push_back(binding->callback);
+            callbacks.push_back({binding->callback, binding->owner});
         }
     }
 
-    for (auto call : callbacks)
+    for (auto [call, owner] : callbacks)
     {
+        wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
         (*call)(ev);
     }
 
@@ -144,8 +149,10 @@ bool wf::bindings_repository_t::handle_button(const wf::buttonbinding_t& pressed
             /* We must be careful because the callback might be erased,
              * so force copy the callback into the lambda */
             auto callback = binding->callback;
+            auto owner    = binding->owner;
             callbacks.emplace_back([=] ()
             {
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 return (*callback)(pressed);
             });
         }
@@ -158,12 +165,14 @@ bool wf::bindings_repository_t::handle_button(const wf::buttonbinding_t& pressed
             /* We must be careful because the callback might be erased,
              * so force copy the callback into the lambda */
             auto callback = binding->callback;
+            auto owner    = binding->owner;
             callbacks.emplace_back([=] ()
             {
                 wf::activator_data_t data = {
                     .source = activator_source_t::BUTTONBINDING,
                     .activation_data = pressed.get_button(),
                 };
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 return (*callback)(data);
             });
         }
@@ -193,12 +202,14 @@ void wf::bindings_repository_t::handle_gesture(const wf::touchgesture_t& gesture
             /* We must be careful because the callback might be erased,
              * so force copy the callback into the lambda */
             auto callback = binding->callback;
+            auto owner    = binding->owner;
             callbacks.emplace_back([=] ()
             {
                 wf::activator_data_t data = {
                     .source = activator_source_t::GESTURE,
                     .activation_data = 0
                 };
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 (*callback)(data);
             });
         }
@@ -210,6 +221,14 @@ void wf::bindings_repository_t::handle_gesture(const wf::touchgesture_t& gesture
     }
 }
 
+bool wf::bindings_repository_t::has_gesture(const wf::touchgesture_t& gesture) const
+{
+    return std::any_of(priv->activators.begin(), priv->activators.end(), [&] (const auto& binding)
+    {
+        return binding->activated_by->get_value().has_match(gesture);
+    });
+}
+
 bool wf::bindings_repository_t::handle_extension_generic(
     std::function<bool(const std::any& stored_tag)> callback, const wf::activator_data_t& data)
 {
@@ -225,7 +244,11 @@ bool wf::bindings_repository_t::handle_extension_generic(
         {
             if (callback(tag))
             {
-                callbacks.emplace_back([cb = binding->callback, &data] () { return (*cb)(data); });
+                callbacks.emplace_back([cb = binding->callback, owner = binding->owner, &data] ()
+                {
+                    wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
+                    return (*cb)(data);
+                });
                 break;
             }
         }
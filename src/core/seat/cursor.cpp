@@ -6,7 +6,9 @@
 #include "wayfire/util.hpp"
 #include "wayfire/output-layout.hpp"
 #include "tablet.hpp"
+#include "pointing-device.hpp"
 #include "wayfire/signal-definitions.hpp"
+#include "wayfire/output.hpp"
 
 wf::cursor_t::cursor_t(wf::seat_t *seat)
 {
@@ -21,8 +23,13 @@ wf::cursor_t::cursor_t(wf::seat_t *seat)
     init_xcursor();
     init_cursor_shape_manager();
 
-    config_reloaded = [=] (auto)
+    config_reloaded = [=] (wf::reload_config_signal *ev)
     {
+        if (!ev->section_changed("input"))
+        {
+            return;
+        }
+
         init_xcursor();
     };
 
@@ -36,6 +43,19 @@ wf::cursor_t::cursor_t(wf::seat_t *seat)
     request_set_cursor.connect(&seat->seat->events.request_set_cursor);
 }
 
+wf::cursor_t::~cursor_t()
+{
+    // The seat is destroyed before the outputs, which must not keep running the hook afterwards.
+    on_output_added.disconnect();
+    if (wf::get_core().output_layout)
+    {
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            wo->render->rem_effect(&flush_before_frame);
+        }
+    }
+}
+
 void wf::cursor_t::add_new_device(wlr_input_device *dev)
 {
     wlr_cursor_attach_input_device(cursor, dev);
@@ -46,14 +66,51 @@ void wf::cursor_t::setup_listeners()
     /* Dispatch pointer events to the pointer_t */
     on_frame.set_callback([&] (void*)
     {
-        seat->priv->lpointer->handle_pointer_frame();
-        wf::get_core().seat->notify_activity();
+        if (pending_motion)
+        {
+            pending_frame = true;
+            return;
+        }
+
+        handle_frame();
     });
     on_frame.connect(&cursor->events.frame);
 
+    on_motion.set_callback([&] (void *data)
+    {
+        set_touchscreen_mode(false);
+        auto ev = static_cast<wlr_pointer_motion_event*>(data);
+        if (!coalesce_motion(ev))
+        {
+            handle_motion(ev);
+        }
+    });
+    on_motion.connect(&cursor->events.motion);
+
+    flush_before_frame = [=] () { flush_pending_motion(); };
+    on_output_added.set_callback([=] (wf::output_added_signal *ev)
+    {
+        ev->output->render->add_effect(&flush_before_frame, OUTPUT_EFFECT_PRE);
+    });
+    wf::get_core().output_layout->connect(&on_output_added);
+    for (auto& wo : wf::get_core().output_layout->get_outputs())
+    {
+        wo->render->add_effect(&flush_before_frame, OUTPUT_EFFECT_PRE);
+    }
+
+    on_device_removed.set_callback([=] (wf::input_device_removed_signal *ev)
+    {
+        if (pending_motion && (&pending_motion->pointer->base == ev->device->get_wlr_handle()))
+        {
+            flush_pending_motion();
+        }
+    });
+    wf::get_core().connect(&on_device_removed);
+
 #define setup_passthrough_callback(evname) \
     on_ ## evname.set_callback([&] (void *data) { \
         set_touchscreen_mode(false); \
+        flush_pending_motion(); \
         auto ev   = static_cast<wlr_pointer_ ## evname ## _event*>(data); \
         auto mode = emit_device_event_signal(ev, &ev->pointer->base); \
         if (mode != wf::input_event_processing_mode_t::IGNORE) \
@@ -66,7 +123,6 @@ void wf::cursor_t::setup_listeners()
     on_ ## evname.connect(&cursor->events.evname);
 
     setup_passthrough_callback(button);
-    setup_passthrough_callback(motion);
     setup_passthrough_callback(motion_absolute);
     setup_passthrough_callback(axis);
     setup_passthrough_callback(swipe_begin);
@@ -86,6 +142,7 @@ void wf::cursor_t::setup_listeners()
 #define setup_tablet_callback(evname) \
     on_tablet_ ## evname.set_callback([&] (void *data) { \
         set_touchscreen_mode(false); \
+        flush_pending_motion(); \
         auto ev = static_cast<wlr_tablet_tool_ ## evname ## _event*>(data); \
         auto handling_mode = emit_device_event_signal(ev, &ev->tablet->base); \
         if (ev->tablet->data) { \
@@ -105,6 +162,91 @@ void wf::cursor_t::setup_listeners()
 #undef setup_tablet_callback
 }
 
+void wf::cursor_t::handle_motion(wlr_pointer_motion_event *ev)
+{
+    auto mode = emit_device_event_signal(ev, &ev->pointer->base);
+    if (mode != wf::input_event_processing_mode_t::IGNORE)
+    {
+        seat->priv->lpointer->handle_pointer_motion(ev, mode);
+        wf::get_core().seat->notify_activity();
+    }
+
+    emit_device_post_event_signal(ev, &ev->pointer->base);
+}
+
+void wf::cursor_t::handle_frame()
+{
+    seat->priv->lpointer->handle_pointer_frame();
+    wf::get_core().seat->notify_activity();
+}
+
+bool wf::cursor_t::coalesce_motion(wlr_pointer_motion_event *ev)
+{
+    auto device = static_cast<wf::pointing_device_t*>(ev->pointer->base.data);
+    if (!device)
+    {
+        flush_pending_motion();
+        return false;
+    }
+
+    device->motion_stats.received++;
+    if (pending_motion && (pending_motion->pointer != ev->pointer))
+    {
+        flush_pending_motion();
+    }
+
+    if (!device->coalesce_motion)
+    {
+        flush_pending_motion();
+        return false;
+    }
+
+    if (pending_motion)
+    {
+        pending_motion->time_msec   = ev->time_msec;
+        pending_motion->delta_x    += ev->delta_x;
+        pending_motion->delta_y    += ev->delta_y;
+        pending_motion->unaccel_dx += ev->unaccel_dx;
+        pending_motion->unaccel_dy += ev->unaccel_dy;
+        device->motion_stats.merged++;
+        return true;
+    }
+
+    pending_motion = *ev;
+    pending_frame  = false;
+
+    // Make sure that a frame comes soon, even if nothing else is damaged
+    auto wo = wf::get_core().output_layout->get_output_at(cursor->x, cursor->y);
+    if (wo)
+    {
+        wo->render->schedule_redraw();
+    }
+
+    coalesce_timeout.set_timeout(MAX_COALESCE_DELAY_MS, [=] () { flush_pending_motion(); });
+    return true;
+}
+
+void wf::cursor_t::flush_pending_motion()
+{
+    if (!pending_motion)
+    {
+        return;
+    }
+
+    // Handlers may cause another flush, so take the pending events out first
+    auto ev = *pending_motion;
+    bool frame = pending_frame;
+    pending_motion.reset();
+    pending_frame = false;
+    coalesce_timeout.disconnect();
+
+    handle_motion(&ev);
+    if (frame)
+    {
+        handle_frame();
+    }
+}
+
 void wf::cursor_t::init_xcursor()
 {
     std::string theme = wf::option_wrapper_t<std::string>("input/cursor_theme");
@@ -5,13 +5,16 @@
 #include "wayfire/plugin.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/util.hpp"
+#include "wayfire/output-layout.hpp"
+#include "wayfire/render-manager.hpp"
+#include <optional>
 
 namespace wf
 {
 struct cursor_t
 {
     cursor_t(wf::seat_t *seat);
-    ~cursor_t() = default;
+    ~cursor_t();
 
     /**
      * Register a new input device.
@@ -63,6 +66,36 @@ struct cursor_t
         on_tablet_button, on_tablet_proximity,
         on_frame;
 
+    /**
+     * Relative motion coalescing, enabled per device with the input/coalesce_motion option.
+     *
+     * Motion events from such devices are not processed right away, but summed up (including the
+     * unaccelerated deltas for relative-pointer clients) into one pending event. It is processed at the
+     * start of the next frame of any output, or before any other pointer, tablet or keyboard event, so that
+     * the order of events is preserved.
+     */
+    std::optional<wlr_pointer_motion_event> pending_motion;
+    /* Whether a pointer frame event arrived after the pending motion */
+    bool pending_frame = false;
+
+    /** Process the pending motion event, if any. */
+    void flush_pending_motion();
+
+    /**
+     * Merge the event into the pending motion if the device has coalescing enabled.
+     * @return Whether the event was merged, otherwise it should be processed right away.
+     */
+    bool coalesce_motion(wlr_pointer_motion_event *ev);
+    void handle_motion(wlr_pointer_motion_event *ev);
+    void handle_frame();
+
+    /* Upper bound on how long motion is held back, in case no output is repainting */
+    static constexpr uint32_t MAX_COALESCE_DELAY_MS = 16;
+    wf::wl_timer<false> coalesce_timeout;
+    wf::effect_hook_t flush_before_frame;
+    wf::signal::connection_t<wf::output_added_signal> on_output_added;
+    wf::signal::connection_t<wf::input_device_removed_signal> on_device_removed;
+
     // Seat events
     wf::wl_listener_wrapper request_set_cursor;
     wf::wl_listener_wrapper request_set_cursor_shape;
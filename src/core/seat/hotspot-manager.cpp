@@ -2,29 +2,17 @@
 #include "wayfire/core.hpp"
 #include <wayfire/output-layout.hpp>
 #include <wayfire/touch/touch.hpp>
+#include <algorithm>
 
-void wf::hotspot_instance_t::process_input_motion(wf::pointf_t gc)
+void wf::hotspot_instance_t::set_output(wf::output_t *output)
 {
-    const auto& reset_hotspot = [&] ()
-    {
-        timer.disconnect();
-        this->armed = true;
-    };
-
-    auto target = wf::get_core().output_layout->get_output_coords_at(gc, gc);
-    if (target != last_output)
-    {
-        reset_hotspot();
-        last_output = target;
-        recalc_geometry();
-    }
-
-    if (!(hotspot_geometry[0] & gc) && !(hotspot_geometry[1] & gc))
-    {
-        reset_hotspot();
-        return;
-    }
+    reset();
+    last_output = output;
+    recalc_geometry();
+}
 
+void wf::hotspot_instance_t::enter()
+{
     if (!timer.is_connected() && this->armed)
     {
         this->armed = false;
@@ -36,6 +24,12 @@ void wf::hotspot_instance_t::process_input_motion(wf::pointf_t gc)
     }
 }
 
+void wf::hotspot_instance_t::reset()
+{
+    timer.disconnect();
+    this->armed = true;
+}
+
 wf::geometry_t wf::hotspot_instance_t::pin(wf::dimensions_t dim) noexcept
 {
     if (!last_output)
@@ -102,10 +96,6 @@ void wf::hotspot_instance_t::recalc_geometry() noexcept
 wf::hotspot_instance_t::hotspot_instance_t(uint32_t edges, uint32_t along, uint32_t away, int32_t timeout,
     std::function<void(uint32_t)> callback)
 {
-    wf::get_core().connect(&on_motion_event);
-    wf::get_core().connect(&on_motion_event);
-    wf::get_core().connect(&on_touch_motion);
-
     this->edges = edges;
     this->along = along;
     this->away  = away;
@@ -113,8 +103,119 @@ wf::hotspot_instance_t::hotspot_instance_t(uint32_t edges, uint32_t along, uint3
     this->callback   = callback;
 
     recalc_geometry();
+}
+
+static const uint32_t index_edges[] = {
+    OUTPUT_EDGE_LEFT, OUTPUT_EDGE_RIGHT, OUTPUT_EDGE_TOP, OUTPUT_EDGE_BOTTOM
+};
+
+int wf::hotspot_index_t::get_reach(int edge, wf::geometry_t rect) const
+{
+    const auto& og = output_geometry;
+    switch (index_edges[edge])
+    {
+      case OUTPUT_EDGE_LEFT:
+        return rect.x + rect.width - og.x;
+
+      case OUTPUT_EDGE_RIGHT:
+        return og.x + og.width - rect.x;
+
+      case OUTPUT_EDGE_TOP:
+        return rect.y + rect.height - og.y;
+
+      default:
+        return og.y + og.height - rect.y;
+    }
+}
+
+double wf::hotspot_index_t::get_distance(int edge, wf::pointf_t point) const
+{
+    const auto& og = output_geometry;
+    switch (index_edges[edge])
+    {
+      case OUTPUT_EDGE_LEFT:
+        return point.x - og.x;
+
+      case OUTPUT_EDGE_RIGHT:
+        return og.x + og.width - point.x;
+
+      case OUTPUT_EDGE_TOP:
+        return point.y - og.y;
+
+      default:
+        return og.y + og.height - point.y;
+    }
+}
+
+void wf::hotspot_index_t::reset(wf::geometry_t output_geometry)
+{
+    this->output_geometry = output_geometry;
+    for (int i = 0; i < NUM_EDGES; i++)
+    {
+        by_edge[i].clear();
+        reach[i] = 0;
+    }
+
+    detached.clear();
+}
+
+void wf::hotspot_index_t::add(uint32_t edges, const wf::geometry_t *rects, size_t nr_rects, size_t id)
+{
+    for (size_t i = 0; i < nr_rects; i++)
+    {
+        // Attach each rectangle to the edge it sticks out the least from. For corner hotspots, this puts the
+        // tall rectangle on the left/right edge and the wide one on the top/bottom edge.
+        int best_edge  = -1;
+        int best_reach = 0;
+        for (int edge = 0; edge < NUM_EDGES; edge++)
+        {
+            int r = get_reach(edge, rects[i]);
+            if ((edges & index_edges[edge]) && ((best_edge < 0) || (r < best_reach)))
+            {
+                best_edge  = edge;
+                best_reach = r;
+            }
+        }
+
+        if (best_edge < 0)
+        {
+            detached.push_back({rects[i], id});
+        } else
+        {
+            by_edge[best_edge].push_back({rects[i], id});
+            reach[best_edge] = std::max(reach[best_edge], best_reach);
+        }
+    }
+}
+
+void wf::hotspot_index_t::query(wf::pointf_t point, std::vector<size_t>& result) const
+{
+    const auto& check = [&] (const std::vector<entry_t>& entries)
+    {
+        for (const auto& entry : entries)
+        {
+            if ((entry.rect & point) &&
+                (std::find(result.begin(), result.end(), entry.id) == result.end()))
+            {
+                result.push_back(entry.id);
+            }
+        }
+    };
 
-    // callbacks
+    for (int edge = 0; edge < NUM_EDGES; edge++)
+    {
+        // At the right and bottom edges, a point inside a rectangle may be exactly at the reach distance.
+        if (!by_edge[edge].empty() && (get_distance(edge, point) <= reach[edge]))
+        {
+            check(by_edge[edge]);
+        }
+    }
+
+    check(detached);
+}
+
+wf::hotspot_manager_t::hotspot_manager_t()
+{
     on_tablet_axis = [=] (wf::post_input_event_signal<wlr_tablet_tool_axis_event> *ev)
     {
         process_input_motion(wf::get_core().get_cursor_position());
@@ -133,23 +234,78 @@ wf::hotspot_instance_t::hotspot_instance_t(uint32_t edges, uint32_t along, uint3
             process_input_motion(wf::get_core().get_touch_position(0));
         }
     };
+
+    wf::get_core().connect(&on_tablet_axis);
+    wf::get_core().connect(&on_motion_event);
+    wf::get_core().connect(&on_touch_motion);
+}
+
+void wf::hotspot_manager_t::set_output(wf::output_t *output)
+{
+    last_output = output;
+    index.reset(output ? output->get_layout_geometry() : wf::geometry_t{0, 0, 0, 0});
+    for (size_t i = 0; i < hotspots.size(); i++)
+    {
+        hotspots[i]->set_output(output);
+        if (output)
+        {
+            index.add(hotspots[i]->get_edges(), hotspots[i]->get_geometry(), 2, i);
+        }
+    }
+
+    engaged.clear();
+}
+
+void wf::hotspot_manager_t::process_input_motion(wf::pointf_t gc)
+{
+    if (hotspots.empty())
+    {
+        return;
+    }
+
+    auto target = wf::get_core().output_layout->get_output_coords_at(gc, gc);
+    if (target != last_output)
+    {
+        set_output(target);
+    }
+
+    matches.clear();
+    index.query(gc, matches);
+    for (auto id : engaged)
+    {
+        if (std::find(matches.begin(), matches.end(), id) == matches.end())
+        {
+            hotspots[id]->reset();
+        }
+    }
+
+    for (auto id : matches)
+    {
+        hotspots[id]->enter();
+    }
+
+    std::swap(engaged, matches);
 }
 
 void wf::hotspot_manager_t::update_hotspots(const container_t& activators)
 {
     hotspots.clear();
+    engaged.clear();
+    last_output = nullptr;
     for (const auto& opt : activators)
     {
         auto opt_hotspots = opt->activated_by->get_value().get_hotspots();
         for (const auto& hs : opt_hotspots)
         {
             auto activator_cb = opt->callback;
-            auto callback = [activator_cb] (uint32_t edges)
+            auto owner = opt->owner;
+            auto callback = [activator_cb, owner] (uint32_t edges)
             {
                 wf::activator_data_t data = {
                     .source = activator_source_t::HOTSPOT,
                     .activation_data = edges,
                 };
+                wf::cost::scope_t scope{owner, wf::cost::category_t::BINDING};
                 (*activator_cb)(data);
             };
 
@@ -7,6 +7,7 @@
 #include <wayfire/util/log.hpp>
 #include <wayfire/signal-definitions.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
+#include <wayfire/cost-accounting.hpp>
 #include <any>
 
 namespace  wf
@@ -20,6 +21,8 @@ struct binding_t
     wf::option_sptr_t<Option> activated_by;
     Callback *callback;
     std::vector<std::any> tags;
+    /* The plugin which added the binding */
+    wf::cost::owner_t owner = wf::cost::current_owner();
 };
 
 template<class Option, class Callback> using binding_container_t =
@@ -27,6 +30,8 @@ template<class Option, class Callback> using binding_container_t =
 
 /**
  * Represents an instance of a hotspot.
+ *
+ * Hotspots do not track input themselves, hotspot_manager_t tells them when the cursor enters or leaves.
  */
 class hotspot_instance_t
 {
@@ -35,6 +40,26 @@ class hotspot_instance_t
     hotspot_instance_t(uint32_t edges, uint32_t along, uint32_t away, int32_t timeout,
         std::function<void(uint32_t)> callback);
 
+    /** Move the hotspot to the given output and recalculate its geometry. */
+    void set_output(wf::output_t *output);
+
+    /** The possible hotspot rectangles on the current output. */
+    const wf::geometry_t *get_geometry() const
+    {
+        return hotspot_geometry;
+    }
+
+    uint32_t get_edges() const
+    {
+        return edges;
+    }
+
+    /** The cursor is inside the hotspot, start the activation timer unless it was already triggered. */
+    void enter();
+
+    /** The cursor is outside of the hotspot, cancel the activation and arm it again. */
+    void reset();
+
   private:
     /** The possible hotspot rectangles */
     wf::geometry_t hotspot_geometry[2];
@@ -61,13 +86,6 @@ class hotspot_instance_t
     /** Callback to execute */
     std::function<void(uint32_t)> callback;
 
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_tablet_tool_axis_event>> on_tablet_axis;
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion_event;
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_touch_motion_event>> on_touch_motion;
-
-    /** Update state based on input motion */
-    void process_input_motion(wf::pointf_t gc);
-
     /** Calculate a rectangle with size @dim inside @og at the correct edges. */
     wf::geometry_t pin(wf::dimensions_t dim) noexcept;
 
@@ -75,20 +93,84 @@ class hotspot_instance_t
     void recalc_geometry() noexcept;
 };
 
+/**
+ * An index of hotspot rectangles on a single output.
+ *
+ * Each rectangle is stored with the output edge it is attached to. For each edge, the index remembers how far
+ * from the edge the furthest rectangle reaches, so that a point which is not near any edge is rejected with
+ * four comparisons, and otherwise only the rectangles of the nearby edges are checked.
+ */
+class hotspot_index_t
+{
+  public:
+    /** Remove all hotspots and set the geometry of the output in the output layout. */
+    void reset(wf::geometry_t output_geometry);
+
+    /**
+     * Add the rectangles of a hotspot with the given edges.
+     * @param id An identifier which is reported by query().
+     */
+    void add(uint32_t edges, const wf::geometry_t *rects, size_t nr_rects, size_t id);
+
+    /**
+     * Find the hotspots which contain the given point (in output-layout coordinates).
+     * The ids of the hotspots are appended to @result, each at most once.
+     */
+    void query(wf::pointf_t point, std::vector<size_t>& result) const;
+
+  private:
+    struct entry_t
+    {
+        wf::geometry_t rect;
+        size_t id;
+    };
+
+    static constexpr int NUM_EDGES = 4;
+    std::vector<entry_t> by_edge[NUM_EDGES];
+    /* Rectangles which are not attached to any edge */
+    std::vector<entry_t> detached;
+    /* How far from each edge the rectangles reach */
+    int reach[NUM_EDGES] = {0, 0, 0, 0};
+    wf::geometry_t output_geometry = {0, 0, 0, 0};
+
+    /** Distance of the rectangle's inner side from the given edge */
+    int get_reach(int edge, wf::geometry_t rect) const;
+    /** Distance of the point from the given edge, positive inside the output */
+    double get_distance(int edge, wf::pointf_t point) const;
+};
+
 /**
  * Manages hotspot bindings on the given output.
  * A part of the bindings_repository_t.
+ *
+ * Input events are processed once for all hotspots: the hotspots near the cursor are found through a
+ * hotspot_index_t for the output the cursor is on.
  */
 class hotspot_manager_t
 {
   public:
-    hotspot_manager_t()
-    {}
+    hotspot_manager_t();
 
     using container_t = binding_container_t<activatorbinding_t, activator_callback>;
     void update_hotspots(const container_t& activators);
 
+    /** Update the hotspots after the cursor moved to @gc (in output-layout coordinates). */
+    void process_input_motion(wf::pointf_t gc);
+
   private:
     std::vector<std::unique_ptr<hotspot_instance_t>> hotspots;
+    hotspot_index_t index;
+    wf::output_t *last_output = nullptr;
+
+    /* Hotspots which contained the cursor at the last event */
+    std::vector<size_t> engaged;
+    /* Hotspots which contain the cursor at the current event */
+    std::vector<size_t> matches;
+
+    void set_output(wf::output_t *output);
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_tablet_tool_axis_event>> on_tablet_axis;
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion_event;
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_touch_motion_event>> on_touch_motion;
 };
 }
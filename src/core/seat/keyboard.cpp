@@ -6,6 +6,7 @@
 
 #include <wayfire/util/log.hpp>
 #include "pointer.hpp"
+#include "cursor.hpp"
 #include "keyboard.hpp"
 #include "../core-impl.hpp"
 #include "touch.hpp"
@@ -16,8 +17,13 @@
 
 void wf::keyboard_t::setup_listeners()
 {
-    on_config_reload = [=] (auto)
+    on_config_reload = [=] (wf::reload_config_signal *ev)
     {
+        if (!ev->section_changed_with_prefix("input"))
+        {
+            return;
+        }
+
         reload_input_options();
     };
     wf::get_core().connect(&on_config_reload);
@@ -25,8 +31,10 @@ void wf::keyboard_t::setup_listeners()
     on_key.set_callback([&] (void *data)
     {
         auto ev    = static_cast<wlr_keyboard_key_event*>(data);
-        auto mode  = emit_device_event_signal(ev, &handle->base);
         auto& seat = wf::get_core_impl().seat;
+        // Bindings may depend on the cursor position, so motion which happened before must be processed first
+        seat->priv->cursor->flush_pending_motion();
+        auto mode = emit_device_event_signal(ev, &handle->base);
         wf::get_core().seat->notify_activity();
 
         if (mode == input_event_processing_mode_t::IGNORE)
@@ -34,6 +34,7 @@ void wf::pointing_device_t::load_options()
     touchpad_accel_profile.load_option(section, "touchpad_accel_profile");
     touchpad_click_method.load_option(section, "click_method");
     touchpad_scroll_method.load_option(section, "scroll_method");
+    coalesce_motion.load_option(section, "coalesce_motion");
 }
 
 static void set_libinput_accel_profile(libinput_device *dev, std::string name)
@@ -32,12 +32,14 @@ wf::touch_interface_t::touch_interface_t(wlr_cursor *cursor, wlr_seat *seat,
     this->cursor = cursor;
     this->seat   = seat;
     this->surface_at = surface_at;
+    this->touch_points.reserve(EXPECTED_TOUCH_POINTS);
 
     // connect handlers
     on_down.set_callback([=] (void *data)
     {
         auto ev   = static_cast<wlr_touch_down_event*>(data);
         auto mode = emit_device_event_signal(ev, &ev->touch->base);
+        flush_pending_motion();
         if (mode != input_event_processing_mode_t::IGNORE)
         {
             double lx, ly;
@@ -56,6 +58,7 @@ wf::touch_interface_t::touch_interface_t(wlr_cursor *cursor, wlr_seat *seat,
     {
         auto ev   = static_cast<wlr_touch_up_event*>(data);
         auto mode = emit_device_event_signal(ev, &ev->touch->base);
+        flush_pending_motion();
         if (mode != input_event_processing_mode_t::IGNORE)
         {
             handle_touch_up(ev->touch_id, ev->time_msec, mode);
@@ -98,6 +101,7 @@ wf::touch_interface_t::touch_interface_t(wlr_cursor *cursor, wlr_seat *seat,
 
     on_frame.set_callback([&] (void*)
     {
+        flush_pending_motion();
         wlr_seat_touch_notify_frame(wf::get_core().get_current_seat());
         wf::get_core().seat->notify_activity();
     });
@@ -115,11 +119,12 @@ wf::touch_interface_t::touch_interface_t(wlr_cursor *cursor, wlr_seat *seat,
             return;
         }
 
-        for (auto& [finger_id, node] : this->focus)
+        for (size_t i = 0; i < touch_points.size(); i++)
         {
-            if (node && !is_grabbed_node_alive(node))
+            auto& point = touch_points[i];
+            if (point.focus && !is_grabbed_node_alive(point.focus))
             {
-                set_touch_focus(nullptr, finger_id, get_current_time(), {0, 0});
+                set_touch_focus(nullptr, point.id, get_current_time(), {0, 0});
             }
         }
     };
@@ -138,8 +143,26 @@ const wf::touch::gesture_state_t& wf::touch_interface_t::get_state() const
 
 wf::scene::node_ptr wf::touch_interface_t::get_focus(int finger_id) const
 {
-    auto it = this->focus.find(finger_id);
-    return (it == focus.end() ? nullptr : it->second);
+    auto point = find_touch_point(finger_id);
+    return point ? point->focus : nullptr;
+}
+
+wf::touch_interface_t::touch_point_t*wf::touch_interface_t::find_touch_point(int32_t id)
+{
+    for (auto& point : touch_points)
+    {
+        if (point.id == id)
+        {
+            return &point;
+        }
+    }
+
+    return nullptr;
+}
+
+const wf::touch_interface_t::touch_point_t*wf::touch_interface_t::find_touch_point(int32_t id) const
+{
+    return const_cast<touch_interface_t*>(this)->find_touch_point(id);
 }
 
 void wf::touch_interface_t::add_touch_gesture(
@@ -159,17 +182,18 @@ void wf::touch_interface_t::rem_touch_gesture(
 void wf::touch_interface_t::set_touch_focus(wf::scene::node_ptr node,
     int id, int64_t time, wf::pointf_t point)
 {
-    if (focus[id] == node)
+    auto touch_point = find_touch_point(id);
+    if (!touch_point || (touch_point->focus == node))
     {
         return;
     }
 
-    if (focus[id])
+    if (touch_point->focus)
     {
-        focus[id]->touch_interaction().handle_touch_up(time, id, point);
+        touch_point->focus->touch_interaction().handle_touch_up(time, id, point);
     }
 
-    focus[id] = node;
+    touch_point->focus = node;
     if (node)
     {
         auto local = get_node_local_coords(node.get(), point);
@@ -185,12 +209,13 @@ void wf::touch_interface_t::set_touch_focus(wf::scene::node_ptr node,
 void wf::touch_interface_t::transfer_grab(scene::node_ptr grab_node)
 {
     auto new_focus = grab_node->wants_raw_input() ? grab_node : nullptr;
-    for (auto& [id, focused_node] : this->focus)
+    for (auto& point : this->touch_points)
     {
+        auto& focused_node = point.focus;
         if (focused_node && (focused_node != new_focus) && !focused_node->wants_raw_input())
         {
-            const auto lift_off_position = finger_state.fingers[id].current;
-            focused_node->touch_interaction().handle_touch_up(get_current_time(), id,
+            const auto lift_off_position = finger_state.fingers[point.id].current;
+            focused_node->touch_interaction().handle_touch_up(get_current_time(), point.id,
                 {lift_off_position.x, lift_off_position.y});
         }
 
@@ -198,6 +223,27 @@ void wf::touch_interface_t::transfer_grab(scene::node_ptr grab_node)
     }
 }
 
+void wf::touch_interface_t::flush_pending_motion()
+{
+    // Gestures may grab input while they are updated, so do not hold references into touch_points.
+    for (size_t i = 0; i < touch_points.size(); i++)
+    {
+        if (!touch_points[i].motion_pending)
+        {
+            continue;
+        }
+
+        touch_points[i].motion_pending = false;
+        const wf::touch::gesture_event_t gesture_event = {
+            .type   = wf::touch::EVENT_TYPE_MOTION,
+            .time   = touch_points[i].motion_time,
+            .finger = touch_points[i].id,
+            .pos    = {touch_points[i].motion_position.x, touch_points[i].motion_position.y}
+        };
+        update_gestures(gesture_event);
+    }
+}
+
 void wf::touch_interface_t::update_gestures(const wf::touch::gesture_event_t& ev)
 {
     for (auto& gesture : this->gestures)
@@ -236,6 +282,10 @@ void wf::touch_interface_t::handle_touch_down(int32_t id, uint32_t time,
         .pos    = {point.x, point.y}
     };
     finger_state.update(gesture_event);
+    if (!find_touch_point(id))
+    {
+        touch_points.push_back({.id = id});
+    }
 
     if (mode != input_event_processing_mode_t::FULL)
     {
@@ -261,22 +311,33 @@ void wf::touch_interface_t::handle_touch_motion(int32_t id, uint32_t time,
     // In case this is not a real event, we don't want to update gestures,
     // because focus change can happen even while some gestures are still
     // updating.
+    auto touch_point = find_touch_point(id);
+    if (!touch_point)
+    {
+        return;
+    }
+
     if (is_real_event)
     {
+        // The finger state is used right away by drag-and-drop, drag icons and plugins which follow the
+        // finger, only the gestures wait for the end of the frame.
         const wf::touch::gesture_event_t gesture_event = {
             .type   = wf::touch::EVENT_TYPE_MOTION,
             .time   = time,
             .finger = id,
             .pos    = {point.x, point.y}
         };
-        update_gestures(gesture_event);
         finger_state.update(gesture_event);
+
+        touch_point->motion_pending  = true;
+        touch_point->motion_time     = time;
+        touch_point->motion_position = point;
     }
 
-    if (focus[id])
+    if (auto focus = touch_point->focus)
     {
-        auto local = get_node_local_coords(focus[id].get(), point);
-        focus[id]->touch_interaction().handle_touch_motion(time, id, local);
+        auto local = get_node_local_coords(focus.get(), point);
+        focus->touch_interaction().handle_touch_motion(time, id, local);
     }
 
     auto& seat = wf::get_core_impl().seat;
@@ -300,6 +361,8 @@ void wf::touch_interface_t::handle_touch_up(int32_t id, uint32_t time,
 
     update_cursor_state();
     set_touch_focus(nullptr, id, time, {lift_off_position.x, lift_off_position.y});
+    touch_points.erase(std::remove_if(touch_points.begin(), touch_points.end(),
+        [id] (const touch_point_t& point) { return point.id == id; }), touch_points.end());
 }
 
 void wf::touch_interface_t::update_cursor_state()
@@ -322,20 +385,28 @@ constexpr static double PINCH_THRESHOLD = 1.5;
 // General
 constexpr static double GESTURE_INITIAL_TOLERANCE = 40;
 constexpr static uint32_t GESTURE_BASE_DURATION   = 400;
+constexpr static int MAX_GESTURE_FINGERS = 10;
+
+static uint32_t wf_touch_to_wf_dir(uint32_t touch_dir);
 
 using namespace wf::touch;
 /**
  * swipe and with multiple fingers and directions
+ *
+ * The action is cancelled as soon as no binding of its type can match anymore: when more fingers are down
+ * than any binding uses, or when the swipe direction is known and no binding uses it.
  */
 class multi_action_t : public gesture_action_t
 {
   public:
-    multi_action_t(bool pinch, double threshold)
+    multi_action_t(wf::touch_gesture_type_t type, bool pinch, double threshold)
     {
-        this->pinch     = pinch;
+        this->type  = type;
+        this->pinch = pinch;
         this->threshold = threshold;
     }
 
+    wf::touch_gesture_type_t type;
     bool pinch;
     double threshold;
     bool last_pinch_was_pinch_in = false;
@@ -344,6 +415,10 @@ class multi_action_t : public gesture_action_t
     uint32_t target_direction = 0;
     int32_t cnt_fingers = 0;
 
+    /** Bit i is set if there is a binding for this gesture type with i fingers */
+    uint32_t bound_fingers = 0;
+    bool bindings_checked  = false;
+
     action_status_t update_state(const gesture_state_t& state,
         const gesture_event_t& event) override
     {
@@ -360,6 +435,16 @@ class multi_action_t : public gesture_action_t
         if (event.type == EVENT_TYPE_TOUCH_DOWN)
         {
             cnt_fingers = state.fingers.size();
+            if (!bindings_checked)
+            {
+                find_bound_fingers();
+            }
+
+            if ((cnt_fingers > MAX_GESTURE_FINGERS) || ((bound_fingers >> cnt_fingers) == 0))
+            {
+                return ACTION_STATUS_CANCELLED;
+            }
+
             for (auto& finger : state.fingers)
             {
                 if (glm::length(finger.second.delta()) > GESTURE_INITIAL_TOLERANCE)
@@ -393,6 +478,10 @@ class multi_action_t : public gesture_action_t
             (this->target_direction == 0))
         {
             this->target_direction = state.get_center().get_direction();
+            if (!has_binding_for_direction(wf_touch_to_wf_dir(target_direction)))
+            {
+                return ACTION_STATUS_CANCELLED;
+            }
         }
 
         if (this->target_direction == 0)
@@ -421,6 +510,41 @@ class multi_action_t : public gesture_action_t
     {
         gesture_action_t::reset(time);
         target_direction = 0;
+        bindings_checked = false;
+    }
+
+  private:
+    /* Bindings are looked up once per gesture, when the first finger is pressed. */
+    void find_bound_fingers()
+    {
+        bound_fingers = 0;
+        for (int fingers = 1; fingers <= MAX_GESTURE_FINGERS; fingers++)
+        {
+            if (wf::get_core().bindings->has_gesture(wf::touchgesture_t{type, 0, fingers}))
+            {
+                bound_fingers |= (1u << fingers);
+            }
+        }
+
+        bindings_checked = true;
+    }
+
+    /**
+     * Check whether the swipe can still complete in the given direction. More fingers may land after the
+     * direction is known, so bindings with more fingers than currently pressed count as well.
+     */
+    bool has_binding_for_direction(uint32_t direction)
+    {
+        for (int fingers = cnt_fingers; fingers <= MAX_GESTURE_FINGERS; fingers++)
+        {
+            if ((bound_fingers & (1u << fingers)) &&
+                wf::get_core().bindings->has_gesture(wf::touchgesture_t{type, direction, fingers}))
+            {
+                return true;
+            }
+        }
+
+        return false;
     }
 };
 
@@ -485,18 +609,18 @@ void wf::touch_interface_t::add_default_gestures()
 
     // Swipe gesture needs slightly less distance because it is usually
     // with many fingers and it is harder to move all of them
-    auto swipe = std::make_unique<multi_action_t>(false,
+    auto swipe = std::make_unique<multi_action_t>(GESTURE_TYPE_SWIPE, false,
         0.75 * MAX_SWIPE_DISTANCE / sensitivity);
     swipe->set_duration(GESTURE_BASE_DURATION * sensitivity);
     swipe->move_tolerance = SWIPE_INCORRECT_DRAG_TOLERANCE * sensitivity;
 
     const double pinch_thresh = 1.0 + (PINCH_THRESHOLD - 1.0) / sensitivity;
-    auto pinch = std::make_unique<multi_action_t>(true, pinch_thresh);
+    auto pinch = std::make_unique<multi_action_t>(GESTURE_TYPE_PINCH, true, pinch_thresh);
     pinch->set_duration(GESTURE_BASE_DURATION * 1.5 * sensitivity);
     pinch->move_tolerance = PINCH_INCORRECT_DRAG_TOLERANCE * sensitivity;
 
     // Edge swipe needs a quick release to be considered edge swipe
-    auto edge_swipe = std::make_unique<multi_action_t>(false,
+    auto edge_swipe = std::make_unique<multi_action_t>(GESTURE_TYPE_EDGE_SWIPE, false,
         MAX_SWIPE_DISTANCE / sensitivity);
     auto edge_release = std::make_unique<wf::touch::touch_action_t>(1, false);
     edge_swipe->set_duration(GESTURE_BASE_DURATION * sensitivity);
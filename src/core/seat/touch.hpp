@@ -1,7 +1,7 @@
 #ifndef TOUCH_HPP
 #define TOUCH_HPP
 
-#include <map>
+#include <vector>
 #include <wayfire/touch/touch.hpp>
 #include "wayfire/scene-input.hpp"
 #include "wayfire/util.hpp"
@@ -67,8 +67,32 @@ class touch_interface_t
 
     touch::gesture_state_t finger_state;
 
-    /** Pressed a finger on a surface and dragging outside of it now */
-    std::map<int, wf::scene::node_ptr> focus;
+    /** Most touchscreens report at most 10 touch points, more are allocated on demand. */
+    static constexpr size_t EXPECTED_TOUCH_POINTS = 10;
+
+    struct touch_point_t
+    {
+        int32_t id;
+        /** Pressed a finger on a surface and dragging outside of it now */
+        wf::scene::node_ptr focus;
+
+        /** Motion which was applied to the finger state, but not passed to the gestures yet */
+        bool motion_pending = false;
+        uint32_t motion_time;
+        wf::pointf_t motion_position;
+    };
+
+    /** The fingers which are currently down, in the order they were pressed. */
+    std::vector<touch_point_t> touch_points;
+    touch_point_t *find_touch_point(int32_t id);
+    const touch_point_t *find_touch_point(int32_t id) const;
+
+    /**
+     * Gestures see the motion of all fingers in a frame together: motion events update the finger state
+     * right away, but the latest position of each finger which moved is passed to the gestures only when the
+     * frame ends, or before the next down or up event.
+     */
+    void flush_pending_motion();
 
     void update_gestures(const wf::touch::gesture_event_t& event);
     std::vector<nonstd::observer_ptr<touch::gesture_t>> gestures;
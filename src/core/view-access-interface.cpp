@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <wlr/util/edges.h>
 
 namespace wf
@@ -22,7 +23,46 @@ view_access_interface_t::view_access_interface_t(wayfire_view view) : _view(view
 view_access_interface_t::~view_access_interface_t()
 {}
 
+view_access_interface_t::property_t view_access_interface_t::intern_property(
+    const std::string & identifier)
+{
+    static const std::unordered_map<std::string, property_t> properties = {
+        {"app_id", property_t::APP_ID},
+        {"title", property_t::TITLE},
+        {"role", property_t::ROLE},
+        {"fullscreen", property_t::FULLSCREEN},
+        {"activated", property_t::ACTIVATED},
+        {"minimized", property_t::MINIMIZED},
+        {"focusable", property_t::FOCUSABLE},
+        {"mapped", property_t::MAPPED},
+        {"tiled-left", property_t::TILED_LEFT},
+        {"tiled-right", property_t::TILED_RIGHT},
+        {"tiled-top", property_t::TILED_TOP},
+        {"tiled-bottom", property_t::TILED_BOTTOM},
+        {"maximized", property_t::MAXIMIZED},
+        {"floating", property_t::FLOATING},
+        {"type", property_t::TYPE},
+    };
+
+    auto it = properties.find(identifier);
+    return it == properties.end() ? property_t::UNKNOWN : it->second;
+}
+
 variant_t view_access_interface_t::get(const std::string & identifier, bool & error)
+{
+    auto property = intern_property(identifier);
+    if (property == property_t::UNKNOWN)
+    {
+        error = false;
+        std::cerr << "View access interface: Get operation triggered to" <<
+            " unsupported view property " << identifier << std::endl;
+        return std::string("");
+    }
+
+    return get(property, error);
+}
+
+variant_t view_access_interface_t::get(property_t property, bool & error)
 {
     variant_t out = std::string(""); // Default to empty string as output.
     error = false; // Assume things will go well.
@@ -35,15 +75,22 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
         return out;
     }
 
-    uint32_t view_tiled_edges = toplevel_cast(_view) ? toplevel_cast(_view)->pending_tiled_edges() : 0;
-    if (identifier == "app_id")
+    const auto& tiled_edges = [&] ()
     {
-        out = _view->get_app_id();
-    } else if (identifier == "title")
+        return toplevel_cast(_view) ? toplevel_cast(_view)->pending_tiled_edges() : 0;
+    };
+
+    switch (property)
     {
+      case property_t::APP_ID:
+        out = _view->get_app_id();
+        break;
+
+      case property_t::TITLE:
         out = _view->get_title();
-    } else if (identifier == "role")
-    {
+        break;
+
+      case property_t::ROLE:
         switch (_view->role)
         {
           case VIEW_ROLE_TOPLEVEL:
@@ -65,92 +112,102 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
             error = true;
             break;
         }
-    } else if (identifier == "fullscreen")
-    {
+
+        break;
+
+      case property_t::FULLSCREEN:
         out = toplevel_cast(_view) ? toplevel_cast(_view)->pending_fullscreen() : false;
-    } else if (identifier == "activated")
-    {
+        break;
+
+      case property_t::ACTIVATED:
         out = toplevel_cast(_view) ? toplevel_cast(_view)->activated : false;
-    } else if (identifier == "minimized")
-    {
+        break;
+
+      case property_t::MINIMIZED:
         out = toplevel_cast(_view) ? toplevel_cast(_view)->minimized : false;
-    } else if (identifier == "focusable")
-    {
+        break;
+
+      case property_t::FOCUSABLE:
         out = _view->is_focusable();
-    } else if (identifier == "mapped")
-    {
+        break;
+
+      case property_t::MAPPED:
         out = _view->is_mapped();
-    } else if (identifier == "tiled-left")
-    {
-        out = ((view_tiled_edges & WLR_EDGE_LEFT) > 0);
-    } else if (identifier == "tiled-right")
-    {
-        out = ((view_tiled_edges & WLR_EDGE_RIGHT) > 0);
-    } else if (identifier == "tiled-top")
-    {
-        out = ((view_tiled_edges & WLR_EDGE_TOP) > 0);
-    } else if (identifier == "tiled-bottom")
-    {
-        out = ((view_tiled_edges & WLR_EDGE_BOTTOM) > 0);
-    } else if (identifier == "maximized")
-    {
-        out = (view_tiled_edges == TILED_EDGES_ALL);
-    } else if (identifier == "floating")
-    {
+        break;
+
+      case property_t::TILED_LEFT:
+        out = ((tiled_edges() & WLR_EDGE_LEFT) > 0);
+        break;
+
+      case property_t::TILED_RIGHT:
+        out = ((tiled_edges() & WLR_EDGE_RIGHT) > 0);
+        break;
+
+      case property_t::TILED_TOP:
+        out = ((tiled_edges() & WLR_EDGE_TOP) > 0);
+        break;
+
+      case property_t::TILED_BOTTOM:
+        out = ((tiled_edges() & WLR_EDGE_BOTTOM) > 0);
+        break;
+
+      case property_t::MAXIMIZED:
+        out = (tiled_edges() == TILED_EDGES_ALL);
+        break;
+
+      case property_t::FLOATING:
         out = toplevel_cast(_view) ? (toplevel_cast(_view)->pending_tiled_edges() == 0) : false;
-    } else if (identifier == "type")
+        break;
+
+      case property_t::TYPE:
+        out = get_type();
+        break;
+
+      case property_t::UNKNOWN:
+        break;
+    }
+
+    return out;
+}
+
+std::string view_access_interface_t::get_type()
+{
+    if (_view->role == VIEW_ROLE_TOPLEVEL)
+    {
+        return "toplevel";
+    }
+
+    if (_view->role == VIEW_ROLE_UNMANAGED)
     {
-        do {
-            if (_view->role == VIEW_ROLE_TOPLEVEL)
-            {
-                out = std::string("toplevel");
-                break;
-            }
-
-            if (_view->role == VIEW_ROLE_UNMANAGED)
-            {
 #if WF_HAS_XWAYLAND
-                auto surf = _view->get_wlr_surface();
-                if (surf && wlr_xwayland_surface_try_from_wlr_surface(surf))
-                {
-                    out = std::string("x-or");
-                    break;
-                }
+        auto surf = _view->get_wlr_surface();
+        if (surf && wlr_xwayland_surface_try_from_wlr_surface(surf))
+        {
+            return "x-or";
+        }
 
 #endif
-                out = std::string("unmanaged");
-                break;
-            }
-
-            if (!_view->get_output())
-            {
-                out = std::string("unknown");
-                break;
-            }
-
-            auto layer = get_view_layer(_view);
-            if ((layer == wf::scene::layer::BACKGROUND) || (layer == wf::scene::layer::BOTTOM))
-            {
-                out = std::string("background");
-            } else if (layer == wf::scene::layer::TOP)
-            {
-                out = std::string("panel");
-            } else if (layer == wf::scene::layer::OVERLAY)
-            {
-                out = std::string("overlay");
-            }
+        return "unmanaged";
+    }
 
-            break;
+    if (!_view->get_output())
+    {
+        return "unknown";
+    }
 
-            out = std::string("unknown");
-        } while (false);
-    } else
+    auto layer = get_view_layer(_view);
+    if ((layer == wf::scene::layer::BACKGROUND) || (layer == wf::scene::layer::BOTTOM))
     {
-        std::cerr << "View access interface: Get operation triggered to" <<
-            " unsupported view property " << identifier << std::endl;
+        return "background";
+    } else if (layer == wf::scene::layer::TOP)
+    {
+        return "panel";
+    } else if (layer == wf::scene::layer::OVERLAY)
+    {
+        return "overlay";
     }
 
-    return out;
+    return "";
 }
 
 void view_access_interface_t::set_view(wayfire_view view)
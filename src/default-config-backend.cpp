@@ -9,8 +9,16 @@
 
 #include <cstring>
 #include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/file.h>
+#include <fcntl.h>
 #include <filesystem>
 #include <unistd.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
 
 #define INOT_BUF_SIZE (sizeof(inotify_event) + NAME_MAX + 1)
 
@@ -26,15 +34,124 @@ static void add_watch(int fd)
     wd_cfg_file = inotify_add_watch(fd, config_file.c_str(), IN_CLOSE_WRITE);
 }
 
-static void reload_config()
+static const char *CONFIG_FILE_ENV = "WAYFIRE_CONFIG_FILE";
+
+namespace wf
+{
+/**
+ * The result of reading and pre-parsing the config file.
+ *
+ * The config file is split into sections, and for each section we keep its
+ * significant lines (without blank lines and comments). This is enough to find
+ * out which sections changed between two reloads, without having to know the
+ * types of the options in them.
+ */
+struct parsed_config_t
+{
+    bool ok = false;
+    std::string error;
+    std::string source;
+    std::map<std::string, std::string> sections;
+};
+
+static std::string trim(const std::string& line)
 {
-    wf::config::load_configuration_options_from_file(*cfg_manager, config_file);
+    const char *ws = " \t\r\n";
+    size_t start   = line.find_first_not_of(ws);
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+
+    return line.substr(start, line.find_last_not_of(ws) - start + 1);
 }
 
-static const char *CONFIG_FILE_ENV = "WAYFIRE_CONFIG_FILE";
+/**
+ * Read the config file and split it into sections.
+ * Does not touch any compositor state, so it is safe to call from a worker thread.
+ */
+static parsed_config_t parse_config_file(const std::string& file)
+{
+    parsed_config_t result;
 
-namespace wf
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        result.error = strerror(errno);
+        return result;
+    }
+
+    // Take the same lock as wf-config does, so that we do not read a half-written file.
+    flock(fd, LOCK_SH);
+    char buf[4096];
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0)
+    {
+        result.source.append(buf, len);
+    }
+
+    if (len < 0)
+    {
+        result.error = strerror(errno);
+    }
+
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (len < 0)
+    {
+        return result;
+    }
+
+    std::istringstream stream{result.source};
+    std::string line, current_section;
+    while (std::getline(stream, line))
+    {
+        line = trim(line);
+        if (line.empty() || (line[0] == '#'))
+        {
+            continue;
+        }
+
+        if ((line.front() == '[') && (line.back() == ']'))
+        {
+            current_section = trim(line.substr(1, line.size() - 2));
+            // Make sure empty sections are also recorded.
+            result.sections[current_section];
+            continue;
+        }
+
+        result.sections[current_section] += line + "\n";
+    }
+
+    result.ok = true;
+    return result;
+}
+
+/** Find the names of the sections which differ between @from and @to. */
+static std::set<std::string> diff_sections(const std::map<std::string, std::string>& from,
+    const std::map<std::string, std::string>& to)
 {
+    std::set<std::string> changed;
+    for (auto& [name, contents] : from)
+    {
+        auto it = to.find(name);
+        if ((it == to.end()) || (it->second != contents))
+        {
+            changed.insert(name);
+        }
+    }
+
+    for (auto& [name, contents] : to)
+    {
+        if (!from.count(name))
+        {
+            changed.insert(name);
+        }
+    }
+
+    return changed;
+}
+
 class dynamic_ini_config_t : public wf::config_backend_t
 {
   private:
@@ -43,6 +160,22 @@ class dynamic_ini_config_t : public wf::config_backend_t
     wf::wl_timer<false> reload_timer;
     wf::option_wrapper_t<int> config_reload_delay;
 
+    /**
+     * Reloads read and parse the config file in a worker thread. When the worker is done, it stores its
+     * result in parse_result and wakes up the main loop via parse_done_fd.
+     */
+    std::thread parse_worker;
+    std::mutex parse_result_mutex;
+    parsed_config_t parse_result;
+    int parse_done_fd = -1;
+    struct wl_event_source *parse_done_evtsrc = nullptr;
+
+    /** A reload was requested while the worker was still busy. */
+    bool reload_pending = false;
+
+    /** The sections of the config file as of the last (re)load. */
+    std::map<std::string, std::string> current_sections;
+
   public:
     /**
      * Schedules a configuration reload after a delay.
@@ -72,6 +205,11 @@ class dynamic_ini_config_t : public wf::config_backend_t
 
         config = wf::config::build_configuration(
             get_xml_dirs(), SYSCONFDIR "/wayfire/defaults.ini", config_file);
+        current_sections = parse_config_file(config_file).sections;
+
+        parse_done_fd     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        parse_done_evtsrc = wl_event_loop_add_fd(wl_display_get_event_loop(display),
+            parse_done_fd, WL_EVENT_READABLE, handle_parse_done, this);
 
         // Load option after building the config, as the option is not present before that.
         config_reload_delay.load_option("workarounds/config_reload_delay");
@@ -137,17 +275,113 @@ class dynamic_ini_config_t : public wf::config_backend_t
     }
 
     /**
-     * Performs the actual configuration reload and emits the signal.
-     * This is called by the wl_timer after the delay.
+     * Start reloading the configuration file.
+     * The file is read and split into sections in a worker thread, and the result is applied in
+     * apply_parsed_config() once the worker is done.
      */
     void do_reload_config()
     {
+        if (parse_worker.joinable())
+        {
+            // Pick up the newest changes once the current reload is done.
+            reload_pending = true;
+            return;
+        }
+
         LOGD("Reloading configuration file now!");
-        reload_config();
+        parse_worker = std::thread([this, file = config_file] ()
+        {
+            auto result = parse_config_file(file);
+            {
+                std::lock_guard<std::mutex> lock(parse_result_mutex);
+                parse_result = std::move(result);
+            }
+
+            uint64_t one = 1;
+            if (write(parse_done_fd, &one, sizeof(one)) < 0)
+            {
+                LOGE("Failed to notify the main loop about the parsed config file!");
+            }
+        });
+    }
+
+    /**
+     * Called on the main loop after the worker thread has parsed the config file.
+     */
+    void on_parse_done()
+    {
+        uint64_t count;
+        if (read(parse_done_fd, &count, sizeof(count)) < 0)
+        {
+            return;
+        }
+
+        parse_worker.join();
+        parsed_config_t result;
+        {
+            std::lock_guard<std::mutex> lock(parse_result_mutex);
+            result = std::move(parse_result);
+        }
+
+        apply_parsed_config(result);
+        if (reload_pending)
+        {
+            reload_pending = false;
+            do_reload_config();
+        }
+    }
+
+    /**
+     * Load the options from the parsed config file and emit the reload signal.
+     * Only the options whose values actually change fire their updated handlers, and listeners of the
+     * reload signal are told which sections changed, so that they can skip unrelated work.
+     */
+    void apply_parsed_config(const parsed_config_t& result)
+    {
+        if (!result.ok)
+        {
+            LOGE("Failed to read configuration file ", config_file, ": ", result.error);
+            return;
+        }
+
+        auto changed = diff_sections(current_sections, result.sections);
+        current_sections = result.sections;
+        if (changed.empty())
+        {
+            LOGD("Configuration file did not change, skipping reload.");
+            return;
+        }
+
+        wf::config::load_configuration_options_from_string(*cfg_manager, result.source, config_file);
         wf::reload_config_signal ev;
+        ev.changed_sections = std::move(changed);
         wf::get_core().emit(&ev);
         check_auto_reload_option(); // Re-check auto-reload option after config has been reloaded
     }
+
+    static int handle_parse_done(int fd, uint32_t mask, void *data)
+    {
+        if (mask & WL_EVENT_READABLE)
+        {
+            static_cast<dynamic_ini_config_t*>(data)->on_parse_done();
+        }
+
+        return 0;
+    }
+
+    ~dynamic_ini_config_t()
+    {
+        if (parse_worker.joinable())
+        {
+            parse_worker.join();
+        }
+
+        // The event source is destroyed together with the event loop.
+        if (parse_done_fd >= 0)
+        {
+            close(parse_done_fd);
+        }
+    }
 };
 }
 
@@ -43,6 +43,7 @@ static void print_help()
     std::cout <<
         " -D,  --damage-debug      enable additional debug for damaged regions" <<
         std::endl;
+    std::cout << " -O,  --damage-overlay    highlight the regions repainted in each frame" << std::endl;
     std::cout << " -R,  --damage-rerender   rerender damaged regions" << std::endl;
     std::cout << " -l,  --legacy-wl-drm     use legacy drm for wayland clients" << std::endl;
     std::cout << " -v,  --version           print version and exit" << std::endl;
@@ -289,6 +290,7 @@ int main(int argc, char *argv[])
         },
         {"debug", optional_argument, NULL, 'd'},
         {"damage-debug", no_argument, NULL, 'D'},
+        {"damage-overlay", no_argument, NULL, 'O'},
         {"damage-rerender", no_argument, NULL, 'R'},
         {"legacy-wl-drm", no_argument, NULL, 'l'},
         {"with-great-power-comes-great-responsibility", no_argument, NULL, 'r'},
@@ -314,7 +316,7 @@ int main(int argc, char *argv[])
     }
 
     int c, i;
-    while ((c = getopt_long(argc, argv, "c:B:d::DhRlrv", opts, &i)) != -1)
+    while ((c = getopt_long(argc, argv, "c:B:d::DOhRlrv", opts, &i)) != -1)
     {
         switch (c)
         {
@@ -330,6 +332,10 @@ int main(int argc, char *argv[])
             runtime_config.damage_debug = true;
             break;
 
+          case 'O':
+            runtime_config.damage_overlay = true;
+            break;
+
           case 'R':
             runtime_config.no_damage_track = true;
             break;
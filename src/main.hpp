@@ -7,6 +7,7 @@ extern struct wf_runtime_config
     bool no_damage_track = false;
     bool legacy_wl_drm   = false;
     bool damage_debug    = false;
+    bool damage_overlay  = false;
 } runtime_config;
 
 namespace wf
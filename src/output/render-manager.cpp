@@ -3,6 +3,7 @@
 #include "wayfire/config-backend.hpp"
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/core.hpp"
+#include "wayfire/cost-accounting.hpp"
 #include "wayfire/debug.hpp"
 #include "wayfire/geometry.hpp"
 #include "wayfire/opengl.hpp"
@@ -18,6 +19,8 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <unordered_map>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/nonstd/safe-list.hpp>
 #include <wayfire/util/log.hpp>
@@ -40,9 +43,22 @@ struct swapchain_damage_manager_t
 
     wf::region_t frame_damage;
     wlr_output *output;
-    wlr_damage_ring damage_ring;
     output_t *wo;
 
+    /**
+     * The damage of the last frames, used to repaint only the outdated parts of the swapchain buffers
+     * and of the scene buffer used by postprocessing effects.
+     */
+    wf::damage_history_t damage_history;
+
+    /* Damage which was added since the last frame, shown by the damage overlay. */
+    wf::region_t content_damage;
+    wf::region_t last_content_damage;
+
+    /* Listeners for the destruction of the buffers tracked in the damage history */
+    std::map<wlr_buffer*, std::unique_ptr<wf::wl_listener_wrapper>> tracked_buffers;
+    std::vector<wlr_buffer*> destroyed_buffers;
+
     bool pending_gamma_lut = false;
 
     std::unique_ptr<wf::scene::render_instance_manager_t> instance_manager;
@@ -71,7 +87,6 @@ struct swapchain_damage_manager_t
 
         output->connect(&output_mode_changed);
 
-        wlr_damage_ring_init(&damage_ring);
         on_needs_frame.set_callback([=] (void*) { schedule_repaint(); });
         on_damage.set_callback([=] (void *data)
         {
@@ -100,11 +115,6 @@ struct swapchain_damage_manager_t
         on_gamma_changed.connect(&wf::get_core().protocols.gamma_v1->events.set_gamma);
     }
 
-    ~swapchain_damage_manager_t()
-    {
-        wlr_damage_ring_finish(&damage_ring);
-    }
-
     wf::signal::connection_t<wf::output_configuration_changed_signal>
     output_mode_changed = [=] (wf::output_configuration_changed_signal *ev)
     {
@@ -127,8 +137,9 @@ struct swapchain_damage_manager_t
             return;
         }
 
-        frame_damage |= region;
-        wlr_damage_ring_add(&damage_ring, region.to_pixman());
+        frame_damage   |= region;
+        content_damage |= region;
+        damage_history.add(region);
         if (repaint)
         {
             schedule_repaint();
@@ -143,8 +154,9 @@ struct swapchain_damage_manager_t
         }
 
         /* Wlroots expects damage after scaling */
-        frame_damage |= box;
-        wlr_damage_ring_add_box(&damage_ring, &box);
+        frame_damage   |= box;
+        content_damage |= box;
+        damage_history.add(box);
         if (repaint)
         {
             schedule_repaint();
@@ -245,11 +257,8 @@ struct swapchain_damage_manager_t
      */
     std::unique_ptr<frame_object_t> start_frame()
     {
-        auto buffer_extents = this->get_buffer_extents();
-        pixman_region32_intersect_rect(&damage_ring.current, &damage_ring.current,
-            buffer_extents.x, buffer_extents.y, buffer_extents.width, buffer_extents.height);
         const bool needs_swap = force_next_frame | output->needs_frame |
-            pixman_region32_not_empty(&damage_ring.current) | (constant_redraw_counter > 0);
+            !(damage_history.get_pending() & get_buffer_extents()).empty() | (constant_redraw_counter > 0);
         force_next_frame = false;
 
         if (!needs_swap)
@@ -315,14 +324,59 @@ struct swapchain_damage_manager_t
      */
     void accumulate_damage(frame_object_t *next_frame)
     {
-        wf::region_t ring_damage;
-        wlr_damage_ring_rotate_buffer(&damage_ring, next_frame->buffer, ring_damage.to_pixman());
+        damage_history.rotate();
+        last_content_damage = std::move(content_damage);
+        content_damage.clear();
+
+        frame_damage |= take_buffer_damage(next_frame->buffer);
+    }
+
+    /**
+     * Get the damage which has to be repainted in the given buffer in the current frame, and mark it as
+     * up to date. The buffer is forgotten automatically when it is destroyed.
+     */
+    wf::region_t take_buffer_damage(wlr_buffer *buffer)
+    {
+        if (!buffer)
+        {
+            return get_buffer_extents();
+        }
+
+        track_buffer(buffer);
+        auto damage = damage_history.get_buffer_damage(buffer, get_buffer_extents());
+        damage_history.mark_painted(buffer);
 
-        frame_damage |= ring_damage;
         if (runtime_config.no_damage_track)
         {
-            frame_damage |= get_buffer_extents();
+            damage |= get_buffer_extents();
+        }
+
+        return damage;
+    }
+
+    void track_buffer(wlr_buffer *buffer)
+    {
+        for (auto destroyed : destroyed_buffers)
+        {
+            tracked_buffers.erase(destroyed);
         }
+
+        destroyed_buffers.clear();
+        if (tracked_buffers.count(buffer))
+        {
+            return;
+        }
+
+        auto on_destroy = std::make_unique<wf::wl_listener_wrapper>();
+        on_destroy->set_callback([=] (void*)
+        {
+            // A new buffer may be allocated at the same address, it must not inherit the history.
+            damage_history.forget(buffer);
+            tracked_buffers[buffer]->disconnect();
+            destroyed_buffers.push_back(buffer);
+        });
+        on_destroy->connect(&buffer->events.destroy);
+        tracked_buffers[buffer] = std::move(on_destroy);
     }
 
     /**
@@ -394,10 +448,13 @@ struct effect_hook_manager_t
 {
     using effect_container_t = wf::safe_list_t<effect_hook_t*>;
     effect_container_t effects[OUTPUT_EFFECT_TOTAL];
+    /* The plugins which added each hook, for cost accounting */
+    std::unordered_map<effect_hook_t*, wf::cost::owner_t> owners;
 
     void add_effect(effect_hook_t *hook, output_effect_type_t type)
     {
         effects[type].push_back(hook);
+        owners[hook] = wf::cost::current_owner();
     }
 
     bool can_scanout() const
@@ -412,12 +469,19 @@ struct effect_hook_manager_t
         {
             effects[i].remove_all(hook);
         }
+
+        owners.erase(hook);
     }
 
     void run_effects(output_effect_type_t type)
     {
-        effects[type].for_each([] (auto effect)
-        { (*effect)(); });
+        effects[type].for_each([&] (auto effect)
+        {
+            auto it = owners.find(effect);
+            wf::cost::scope_t scope{it != owners.end() ? it->second : wf::cost::CORE,
+                wf::cost::category_t::EFFECT};
+            (*effect)();
+        });
     }
 };
 
@@ -428,10 +492,22 @@ struct postprocessing_manager_t
 {
     using post_container_t = wf::safe_list_t<post_hook_t*>;
     post_container_t post_effects;
-    wf::auxilliary_buffer_t post_buffers[2];
+    std::map<post_hook_t*, post_hook_footprint_t> footprints;
+    /* The plugins which added each hook, for cost accounting */
+    std::map<post_hook_t*, wf::cost::owner_t> owners;
+
+    /**
+     * The scene is rendered to the default buffer, which is kept up-to-date across frames, as only the
+     * damaged parts are repainted. The other two buffers are used alternately as intermediate targets of the
+     * post hooks, and are valid only in the region processed during the current frame.
+     */
+    wf::auxilliary_buffer_t post_buffers[3];
     /* Buffer to which other operations render to */
     static constexpr uint32_t default_out_buffer = 0;
 
+    /* The region which the currently running post hook has to update */
+    wf::region_t current_post_damage;
+
     output_t *output;
     uint32_t output_width, output_height;
     postprocessing_manager_t(output_t *output)
@@ -448,50 +524,127 @@ struct postprocessing_manager_t
         };
     }
 
-    void allocate(int width, int height)
+    /**
+     * Make sure the buffers for the post hooks have the given size.
+     *
+     * @return True if the contents of the default buffer were lost and it has to be repainted fully.
+     */
+    bool allocate(int width, int height)
     {
         if (post_effects.size() == 0)
         {
-            return;
+            return false;
         }
 
         output_width  = width;
         output_height = height;
-        for (auto& buffer : post_buffers)
+
+        bool lost_contents = post_buffers[default_out_buffer].allocate({width, height}) !=
+            wf::buffer_reallocation_result_t::SAME;
+        const int nr_intermediate = std::min<int>(post_effects.size() - 1, 2);
+        for (int i = 0; i < nr_intermediate; i++)
         {
-            buffer.allocate({width, height});
+            post_buffers[1 + i].allocate({width, height});
         }
+
+        return lost_contents;
     }
 
-    void add_post(post_hook_t *hook)
+    void add_post(post_hook_t *hook, post_hook_footprint_t footprint)
     {
         post_effects.push_back(hook);
+        footprints[hook] = footprint;
+        owners[hook]     = wf::cost::current_owner();
         output->render->damage_whole_idle();
     }
 
     void rem_post(post_hook_t *hook)
     {
         post_effects.remove_all(hook);
+        footprints.erase(hook);
+        owners.erase(hook);
         output->render->damage_whole_idle();
     }
 
-    /* Run all postprocessing effects, rendering to alternating buffers and
-     * finally to the screen.
+    /**
+     * Grow the given region by the footprint of a hook.
+     */
+    wf::region_t expand_by_footprint(wf::region_t region, post_hook_t *hook, const wlr_box& extents)
+    {
+        if (region.empty())
+        {
+            return region;
+        }
+
+        auto it = footprints.find(hook);
+        if ((it == footprints.end()) || it->second.whole_output)
+        {
+            return extents;
+        }
+
+        if (it->second.radius > 0)
+        {
+            region.expand_edges(it->second.radius);
+        }
+
+        return region & extents;
+    }
+
+    std::vector<post_hook_t*> get_post_effects()
+    {
+        std::vector<post_hook_t*> hooks;
+        post_effects.for_each([&] (auto post) { hooks.push_back(post); });
+        return hooks;
+    }
+
+    /**
+     * Calculate which parts of the final image change, given the damage of the scene (both in buffer-local
+     * coordinates).
+     */
+    wf::region_t propagate_damage(wf::region_t damage, const wlr_box& extents)
+    {
+        for (auto& post : get_post_effects())
+        {
+            damage = expand_by_footprint(damage, post, extents);
+        }
+
+        return damage;
+    }
+
+    /**
+     * Run all postprocessing effects, rendering to alternating buffers and finally to the screen.
      *
-     * NB: 2 buffers just aren't enough. We render to the zero buffer, and then
-     * we alternately render to the second and the third. The reason: We track
-     * damage. So, we need to keep the whole buffer each frame. */
-    void run_post_effects()
-    {
-        int cur_idx = 0;
-        post_effects.for_each([&] (auto post) -> void
-        {
-            int next_idx = 1 - cur_idx;
-            wf::render_buffer_t dst_buffer = (post == post_effects.back() ?
-                final_target : post_buffers[next_idx].get_renderbuffer());
-            (*post)(post_buffers[cur_idx], dst_buffer);
-            cur_idx = next_idx;
-        });
+     * Going backwards from the final image, each hook has to produce the region required by the next hook,
+     * so that in the end @swap_damage is updated.
+     */
+    void run_post_effects(const wf::region_t& swap_damage, const wlr_box& extents)
+    {
+        auto hooks = get_post_effects();
+        std::vector<wf::region_t> regions(hooks.size());
+        wf::region_t required = swap_damage;
+        for (int i = (int)hooks.size() - 1; i >= 0; i--)
+        {
+            regions[i] = required;
+            required   = expand_by_footprint(required, hooks[i], extents);
+        }
+
+        for (size_t i = 0; i < hooks.size(); i++)
+        {
+            if (regions[i].empty())
+            {
+                continue;
+            }
+
+            auto& src_buffer = (i == 0) ? post_buffers[default_out_buffer] : post_buffers[1 + (i - 1) % 2];
+            wf::render_buffer_t dst_buffer = (i == hooks.size() - 1 ?
+                final_target : post_buffers[1 + i % 2].get_renderbuffer());
+
+            current_post_damage = regions[i];
+            wf::cost::scope_t scope{owners[hooks[i]], wf::cost::category_t::POST};
+            (*hooks[i])(src_buffer, dst_buffer);
+        }
+
+        current_post_damage.clear();
     }
 
     wf::render_target_t get_target_framebuffer() const
@@ -800,6 +953,8 @@ class wf::render_manager::impl
 
     output_t *output;
     wf::region_t swap_damage;
+    /* Flips on each frame of this output which shows the damage overlay */
+    bool overlay_frame_parity = false;
     std::unique_ptr<swapchain_damage_manager_t> damage_manager;
     std::unique_ptr<effect_hook_manager_t> effects;
     std::unique_ptr<postprocessing_manager_t> postprocessing;
@@ -928,6 +1083,7 @@ class wf::render_manager::impl
 
     ~impl()
     {
+        wf::cost::forget_output(output->handle);
         set_icc_transform(nullptr);
     }
 
@@ -1005,12 +1161,29 @@ class wf::render_manager::impl
 
         params.target = postprocessing->get_target_framebuffer().translated(
             wf::origin(output->get_layout_geometry()));
-        params.damage = damage_manager->get_scheduled_damage(params.target);
+        if (postprocessing->post_effects.size())
+        {
+            // The scene buffer is repainted on every frame, so it is usually much less outdated than the
+            // swapchain buffer, whose damage is left for the post effects to repaint.
+            auto scene_buffer = postprocessing->post_buffers[postprocessing->default_out_buffer].get_buffer();
+            wf::region_t scene_damage = damage_manager->take_buffer_damage(scene_buffer) |
+                damage_manager->damage_history.get_pending();
+            params.damage = params.target.geometry_region_from_framebuffer_region(scene_damage) &
+                params.target.geometry;
+        } else
+        {
+            params.damage = damage_manager->get_scheduled_damage(params.target);
+        }
 
         params.background_color = background_color_opt;
         params.reference_output = this->output;
         params.renderer = output->handle->renderer;
         params.flags    = RPASS_CLEAR_BACKGROUND | RPASS_EMIT_SIGNALS;
+        if (postprocessing->post_effects.size())
+        {
+            // Post hooks may hand the scene buffer to another renderer, let them synchronize with the pass.
+            params.flags |= RPASS_SIGNAL_FENCE;
+        }
 
         pass_opts.timer = NULL; // TODO: do we care about this? could be useful for dynamic frame scheduling
         pass_opts.color_transform = icc_color_transform;
@@ -1036,8 +1209,10 @@ class wf::render_manager::impl
 
     void update_bound_output(wlr_buffer *buffer)
     {
-        /* Make sure the default buffer has enough size */
+        /* Make sure the default buffer has enough size. If it is reallocated, its damage history is
+         * discarded together with the old buffer, so it will be repainted fully. */
         postprocessing->allocate(output->handle->width, output->handle->height);
+
         postprocessing->set_current_buffer(buffer);
 
         if (wf::get_core().is_gles2())
@@ -1061,6 +1236,7 @@ class wf::render_manager::impl
     void paint()
     {
         /* Part 1: frame setup: query damage, etc. */
+        wf::cost::collect_gpu_timers(output->handle);
         effects->run_effects(OUTPUT_EFFECT_PRE);
         effects->run_effects(OUTPUT_EFFECT_DAMAGE);
 
@@ -1093,6 +1269,8 @@ class wf::render_manager::impl
 
         /* Part 4: we are done with the main scene. Submit the main render pass. */
         const bool pass_status = current_pass->submit();
+        postprocessing->post_buffers[postprocessing->default_out_buffer].set_ready_fence(
+            current_pass->get_fence());
         current_pass.reset();
         if (!pass_status)
         {
@@ -1106,14 +1284,21 @@ class wf::render_manager::impl
         /* Part 5: finalize the scene: postprocessing effects */
         if (postprocessing->post_effects.size())
         {
-            swap_damage |= damage_manager->get_buffer_extents();
+            // Besides the parts of the scene which changed, the swapchain buffer may be outdated in the
+            // parts which changed since it was last used.
+            swap_damage |= damage_manager->frame_damage & damage_manager->get_buffer_extents();
+            swap_damage  = postprocessing->propagate_damage(swap_damage,
+                damage_manager->get_buffer_extents());
+            postprocessing->run_post_effects(swap_damage, damage_manager->get_buffer_extents());
         }
 
-        postprocessing->run_post_effects();
-
         /* Part 6: render sw cursors We render software cursors after everything else
          * for consistency with hardware cursor planes */
         render_sw_cursors(next_frame.get());
+        if (runtime_config.damage_overlay)
+        {
+            render_damage_overlay(next_frame.get());
+        }
 
         /* Part 7: finalize frame: swap buffers, send frame_done, etc */
         damage_manager->swap_buffers(std::move(next_frame), swap_damage);
@@ -1138,6 +1323,44 @@ class wf::render_manager::impl
         wlr_render_pass_submit(sw_cursor_pass);
     }
 
+    /**
+     * Tint the parts of the output which were repainted because of new damage in this frame.
+     * The tint itself is damaged, so that it is removed the next time the buffer is used.
+     */
+    void render_damage_overlay(swapchain_damage_manager_t::frame_object_t *next_frame)
+    {
+        wf::region_t repainted = damage_manager->last_content_damage & swap_damage;
+        if (repainted.empty())
+        {
+            return;
+        }
+
+        auto overlay_pass =
+            wlr_renderer_begin_buffer_pass(output->handle->renderer, next_frame->buffer, nullptr);
+        if (!overlay_pass)
+        {
+            LOGE("Failed to render damage overlay!");
+            return;
+        }
+
+        // Alternate between two colors, so that consecutive frames can be told apart.
+        overlay_frame_parity = !overlay_frame_parity;
+        wlr_render_rect_options opts{};
+        opts.color = overlay_frame_parity ?
+            wlr_render_color{0.25f, 0.0f, 0.1f, 0.25f} : wlr_render_color{0.0f, 0.1f, 0.25f, 0.25f};
+        opts.blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED;
+        for (const auto& box : repainted)
+        {
+            opts.box = wlr_box_from_pixman_box(box);
+            wlr_render_pass_add_rect(overlay_pass, &opts);
+        }
+
+        wlr_render_pass_submit(overlay_pass);
+
+        // Damage only the history, so that the tint does not show up as new damage in the next frame.
+        damage_manager->damage_history.add(repainted);
+    }
+
     /**
      * Execute post-paint actions.
      */
@@ -1194,6 +1417,11 @@ wf::region_t render_manager::get_swap_damage()
     return pimpl->get_swap_damage();
 }
 
+wf::region_t render_manager::get_post_damage()
+{
+    return pimpl->postprocessing->current_post_damage;
+}
+
 void render_manager::schedule_redraw()
 {
     pimpl->damage_manager->schedule_repaint();
@@ -1214,9 +1442,9 @@ void render_manager::rem_effect(effect_hook_t *hook)
     pimpl->effects->rem_effect(hook);
 }
 
-void render_manager::add_post(post_hook_t *hook)
+void render_manager::add_post(post_hook_t *hook, post_hook_footprint_t footprint)
 {
-    pimpl->postprocessing->add_post(hook);
+    pimpl->postprocessing->add_post(hook, footprint);
 }
 
 void render_manager::rem_post(post_hook_t *hook)
@@ -4,7 +4,10 @@
 #include "wayfire/nonstd/reverse.hpp"
 #include "wayfire/opengl.hpp"
 #include <wayfire/scene-render.hpp>
+#include <wayfire/cost-accounting.hpp>
 #include <drm_fourcc.h>
+#include <unistd.h>
+#include <algorithm>
 
 wf::render_buffer_t::render_buffer_t(wlr_buffer *buffer, wf::dimensions_t size)
 {
@@ -12,6 +15,122 @@ wf::render_buffer_t::render_buffer_t(wlr_buffer *buffer, wf::dimensions_t size)
     this->size   = size;
 }
 
+wf::render_fence_t::render_fence_t(wlr_drm_syncobj_timeline *timeline, uint64_t point)
+{
+    this->timeline = timeline ? wlr_drm_syncobj_timeline_ref(timeline) : NULL;
+    this->point    = point;
+}
+
+wf::render_fence_t::~render_fence_t()
+{
+    if (timeline)
+    {
+        wlr_drm_syncobj_timeline_unref(timeline);
+    }
+}
+
+wf::render_fence_t::render_fence_t(const render_fence_t& other) :
+    render_fence_t(other.timeline, other.point)
+{}
+
+wf::render_fence_t& wf::render_fence_t::operator =(const render_fence_t& other)
+{
+    if (&other == this)
+    {
+        return *this;
+    }
+
+    if (timeline)
+    {
+        wlr_drm_syncobj_timeline_unref(timeline);
+    }
+
+    this->timeline = other.timeline ? wlr_drm_syncobj_timeline_ref(other.timeline) : NULL;
+    this->point    = other.point;
+    return *this;
+}
+
+bool wf::render_fence_t::has_sync_point() const
+{
+    return timeline != NULL;
+}
+
+bool wf::render_fence_t::is_signaled() const
+{
+    if (!timeline)
+    {
+        return true;
+    }
+
+    bool signaled = false;
+    if (!wlr_drm_syncobj_timeline_check(timeline, point, 0, &signaled))
+    {
+        LOGE("Failed to check render fence state!");
+        return true;
+    }
+
+    return signaled;
+}
+
+int wf::render_fence_t::export_sync_file() const
+{
+    if (!timeline)
+    {
+        return -1;
+    }
+
+    return wlr_drm_syncobj_timeline_export_sync_file(timeline, point);
+}
+
+std::unique_ptr<wf::render_fence_waiter_t> wf::render_fence_t::wait_async(
+    std::function<void()> callback) const
+{
+    std::unique_ptr<render_fence_waiter_t> waiter{new render_fence_waiter_t};
+    waiter->callback = std::move(callback);
+
+    // A sync_file becomes readable once the fence is signaled.
+    waiter->fd = is_signaled() ? -1 : export_sync_file();
+    if (waiter->fd < 0)
+    {
+        auto w = waiter.get();
+        waiter->idle.run_once([w] () { w->run_callback(); });
+        return waiter;
+    }
+
+    auto loop = wf::wl_idle_call::loop ?: wf::get_core().ev_loop;
+    waiter->source = wl_event_loop_add_fd(loop, waiter->fd, WL_EVENT_READABLE,
+        [] (int, uint32_t, void *data)
+    {
+        auto w = (render_fence_waiter_t*)data;
+        wl_event_source_remove(w->source);
+        w->source = NULL;
+        w->run_callback();
+        return 0;
+    }, waiter.get());
+
+    return waiter;
+}
+
+void wf::render_fence_waiter_t::run_callback()
+{
+    // The callback may destroy the waiter, so it must not run from inside the waiter.
+    auto cb = std::move(callback);
+    cb();
+}
+
+wf::render_fence_waiter_t::~render_fence_waiter_t()
+{
+    if (source)
+    {
+        wl_event_source_remove(source);
+    }
+
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
 wf::auxilliary_buffer_t::auxilliary_buffer_t(auxilliary_buffer_t&& other)
 {
     *this = std::move(other);
@@ -26,6 +145,7 @@ wf::auxilliary_buffer_t& wf::auxilliary_buffer_t::operator =(auxilliary_buffer_t
 
     this->texture = std::exchange(other.texture, nullptr);
     this->buffer  = std::exchange(other.buffer, {});
+    this->ready_fence = std::exchange(other.ready_fence, {});
     return *this;
 }
 
@@ -182,6 +302,98 @@ void wf::auxilliary_buffer_t::free()
 
     buffer.buffer = NULL;
     buffer.size   = {0, 0};
+    ready_fence   = {};
+}
+
+wf::damage_history_t::damage_history_t(int max_age)
+{
+    this->max_age = std::max(max_age, 1);
+}
+
+void wf::damage_history_t::add(const wf::region_t& damage)
+{
+    pending |= damage;
+}
+
+const wf::region_t& wf::damage_history_t::get_pending() const
+{
+    return pending;
+}
+
+void wf::damage_history_t::rotate()
+{
+    if ((int)history.size() == max_age)
+    {
+        history.erase(history.begin());
+    }
+
+    history.push_back(std::move(pending));
+    pending.clear();
+    ++current_frame;
+
+    // Drop buffers which are too old to be repainted partially anyway.
+    painted.erase(std::remove_if(painted.begin(), painted.end(), [&] (const auto& entry)
+    {
+        return current_frame - entry.second > (uint64_t)max_age;
+    }), painted.end());
+}
+
+wf::region_t wf::damage_history_t::get_buffer_damage(const void *buffer, const wf::geometry_t& extents) const
+{
+    auto it = std::find_if(painted.begin(), painted.end(),
+        [&] (const auto& entry) { return entry.first == buffer; });
+    if (it == painted.end())
+    {
+        return extents;
+    }
+
+    const uint64_t age = current_frame - it->second;
+    if (age > history.size())
+    {
+        return extents;
+    }
+
+    wf::region_t damage;
+    for (size_t i = history.size() - age; i < history.size(); i++)
+    {
+        damage |= history[i];
+    }
+
+    return damage & extents;
+}
+
+void wf::damage_history_t::mark_painted(const void *buffer)
+{
+    auto it = std::find_if(painted.begin(), painted.end(),
+        [&] (const auto& entry) { return entry.first == buffer; });
+    if (it == painted.end())
+    {
+        painted.emplace_back(buffer, current_frame);
+    } else
+    {
+        it->second = current_frame;
+    }
+}
+
+void wf::damage_history_t::forget(const void *buffer)
+{
+    painted.erase(std::remove_if(painted.begin(), painted.end(),
+        [&] (const auto& entry) { return entry.first == buffer; }), painted.end());
+}
+
+void wf::damage_history_t::forget_all()
+{
+    painted.clear();
+}
+
+void wf::auxilliary_buffer_t::set_ready_fence(const render_fence_t& fence)
+{
+    this->ready_fence = fence;
+}
+
+const wf::render_fence_t& wf::auxilliary_buffer_t::get_ready_fence() const
+{
+    return ready_fence;
 }
 
 wlr_buffer*wf::auxilliary_buffer_t::get_buffer() const
@@ -390,6 +602,112 @@ wf::region_t wf::render_pass_t::run(const wf::render_pass_params_t& params)
     return damage;
 }
 
+/**
+ * The approximate cost of one additional draw call, expressed as the number of pixels which could have
+ * been painted instead.
+ */
+static constexpr int64_t DRAW_CALL_COST_PIXELS = 64 * 64;
+
+wf::region_t wf::render_pass_t::coalesce_damage(const wf::region_t& damage)
+{
+    int64_t nr_rects = 0;
+    int64_t area     = 0;
+    for (const auto& rect : damage)
+    {
+        ++nr_rects;
+        area += int64_t(rect.x2 - rect.x1) * (rect.y2 - rect.y1);
+    }
+
+    if (nr_rects <= 1)
+    {
+        return damage;
+    }
+
+    auto extents = damage.get_extents();
+    const int64_t extents_area = int64_t(extents.x2 - extents.x1) * (extents.y2 - extents.y1);
+    if (extents_area - area < (nr_rects - 1) * DRAW_CALL_COST_PIXELS)
+    {
+        return wf::region_t{wlr_box_from_pixman_box(extents)};
+    }
+
+    return damage;
+}
+
+/**
+ * The timeline on which render passes signal their fences.
+ * Only the core renderer is supported, other renderers do not produce fences.
+ *
+ * The timeline is stored on core and is bound to the renderer it was created for. It is released together
+ * with that renderer, and a new one is created if the renderer is replaced.
+ */
+class pass_timeline_t : public wf::custom_data_t
+{
+  public:
+    wlr_renderer *renderer;
+    wlr_drm_syncobj_timeline *timeline = NULL;
+    uint64_t last_point = 0;
+
+    pass_timeline_t(wlr_renderer *renderer) : renderer(renderer)
+    {
+        const int drm_fd = wlr_renderer_get_drm_fd(renderer);
+        if (renderer->features.timeline && (drm_fd >= 0))
+        {
+            timeline = wlr_drm_syncobj_timeline_create(drm_fd);
+        }
+
+        if (!timeline)
+        {
+            LOGD("Renderer does not support timelines, render passes will not have fences.");
+        }
+
+        on_renderer_destroy.set_callback([=] (void*) { release(); });
+        on_renderer_destroy.connect(&renderer->events.destroy);
+    }
+
+    ~pass_timeline_t()
+    {
+        release();
+    }
+
+    pass_timeline_t(const pass_timeline_t&) = delete;
+    pass_timeline_t(pass_timeline_t&&) = delete;
+    pass_timeline_t& operator =(const pass_timeline_t&) = delete;
+    pass_timeline_t& operator =(pass_timeline_t&&) = delete;
+
+  private:
+    wf::wl_listener_wrapper on_renderer_destroy;
+
+    void release()
+    {
+        // Fences which are still alive hold their own reference to the timeline.
+        if (timeline)
+        {
+            wlr_drm_syncobj_timeline_unref(timeline);
+            timeline = NULL;
+        }
+
+        renderer = NULL;
+        on_renderer_destroy.disconnect();
+    }
+};
+
+static pass_timeline_t *get_pass_timeline(wlr_renderer *renderer)
+{
+    if (renderer != wf::get_core().renderer)
+    {
+        return nullptr;
+    }
+
+    auto data = wf::get_core().get_data<pass_timeline_t>();
+    if (!data || (data->renderer != renderer))
+    {
+        wf::get_core().store_data(std::make_unique<pass_timeline_t>(renderer));
+        data = wf::get_core().get_data<pass_timeline_t>();
+    }
+
+    return data->timeline ? data.get() : nullptr;
+}
+
 wf::region_t wf::render_pass_t::run_partial()
 {
     auto accumulated_damage = params.damage;
@@ -400,6 +718,13 @@ wf::region_t wf::render_pass_t::run_partial()
         wf::get_core().emit(&ev);
     }
 
+    if (params.flags & RPASS_CLEAR_BACKGROUND)
+    {
+        // The whole damaged area is repainted from scratch, so we are free to repaint a bit more of it if
+        // that saves draw calls.
+        accumulated_damage = coalesce_damage(accumulated_damage);
+    }
+
     wf::region_t swap_damage = accumulated_damage;
 
     // Gather instructions
@@ -413,10 +738,30 @@ wf::region_t wf::render_pass_t::run_partial()
         }
     }
 
+    wlr_buffer_pass_options pass_opts{};
+    if (params.pass_opts)
+    {
+        pass_opts = *params.pass_opts;
+    }
+
+    this->fence = {};
+    pass_timeline_t *timeline = (params.flags & RPASS_SIGNAL_FENCE) ? get_pass_timeline(params.renderer) :
+        nullptr;
+    if (timeline)
+    {
+        pass_opts.signal_timeline = timeline->timeline;
+        pass_opts.signal_point    = ++timeline->last_point;
+    }
+
+    if (!pass_opts.timer)
+    {
+        pass_opts.timer = wf::cost::create_gpu_timer(params.renderer ?: wf::get_core().renderer);
+    }
+
     this->pass = wlr_renderer_begin_buffer_pass(
         params.renderer ?: wf::get_core().renderer,
         params.target.get_buffer(),
-        params.pass_opts);
+        &pass_opts);
 
     if (!pass)
     {
@@ -424,6 +769,11 @@ wf::region_t wf::render_pass_t::run_partial()
         return accumulated_damage;
     }
 
+    if (timeline)
+    {
+        this->fence = render_fence_t{timeline->timeline, timeline->last_point};
+    }
+
     // Clear visible background areas
     if (params.flags & RPASS_CLEAR_BACKGROUND)
     {
@@ -434,6 +784,7 @@ wf::region_t wf::render_pass_t::run_partial()
     for (auto& instr : wf::reverse(instructions))
     {
         instr.pass = this;
+        wf::cost::scope_t scope{instr.instance->cost_owner, wf::cost::category_t::RENDER};
         instr.instance->render(instr);
         if (params.reference_output)
         {
@@ -450,6 +801,11 @@ wf::region_t wf::render_pass_t::run_partial()
     return swap_damage;
 }
 
+wf::render_fence_t wf::render_pass_t::get_fence() const
+{
+    return fence;
+}
+
 wf::render_target_t wf::render_pass_t::get_target() const
 {
     return params.target;
@@ -487,6 +843,14 @@ void wf::render_pass_t::clear(const wf::region_t& region, const wf::color_t& col
 void wf::render_pass_t::add_texture(const wf::texture_t& texture, const wf::render_target_t& adjusted_target,
     const wlr_fbox& geometry, const wf::region_t& damage, float alpha)
 {
+    // Only the damaged parts of the texture are drawn, skip the operation entirely if there are none, and
+    // avoid transforming the rest of the damage region.
+    wf::region_t visible_damage = damage & round_fbox_to_containing_box(geometry);
+    if (visible_damage.empty())
+    {
+        return;
+    }
+
     if (wlr_renderer_is_gles2(this->get_wlr_renderer()))
     {
         // This is a hack to make sure that plugins can do whatever they want and we render on the correct
@@ -496,7 +860,7 @@ void wf::render_pass_t::add_texture(const wf::texture_t& texture, const wf::rend
         wf::gles::bind_render_buffer(adjusted_target);
     }
 
-    wf::region_t fb_damage = adjusted_target.framebuffer_region_from_geometry_region(damage);
+    wf::region_t fb_damage = adjusted_target.framebuffer_region_from_geometry_region(visible_damage);
 
     wlr_render_texture_options opts{};
     opts.texture = texture.texture;
@@ -520,12 +884,18 @@ void wf::render_pass_t::add_texture(const wf::texture_t& texture, const wf::rend
 void wf::render_pass_t::add_rect(const wf::color_t& color, const wf::render_target_t& adjusted_target,
     const wlr_fbox& geometry, const wf::region_t& damage)
 {
+    wf::region_t visible_damage = damage & round_fbox_to_containing_box(geometry);
+    if (visible_damage.empty())
+    {
+        return;
+    }
+
     if (wlr_renderer_is_gles2(this->get_wlr_renderer()))
     {
         wf::gles::bind_render_buffer(adjusted_target);
     }
 
-    wf::region_t fb_damage = adjusted_target.framebuffer_region_from_geometry_region(damage);
+    wf::region_t fb_damage = adjusted_target.framebuffer_region_from_geometry_region(visible_damage);
     wlr_render_rect_options opts;
     opts.color = {
         .r = static_cast<float>(color.r),
@@ -557,6 +927,12 @@ bool wf::render_pass_t::submit()
 {
     bool status = wlr_render_pass_submit(pass);
     this->pass = NULL;
+    if (!status)
+    {
+        // The sync point will never be signaled.
+        this->fence = {};
+    }
+
     return status;
 }
 
@@ -583,6 +959,7 @@ wf::render_pass_t& wf::render_pass_t::operator =(render_pass_t&& other)
     this->pass   = other.pass;
     other.pass   = NULL;
     this->params = other.params;
+    this->fence  = std::exchange(other.fence, {});
     return *this;
 }
 
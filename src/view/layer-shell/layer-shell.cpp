@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <optional>
 
 #include <wayfire/seat.hpp>
 #include <wayfire/workarea.hpp>
@@ -27,6 +28,22 @@ static const uint32_t both_vert =
 static const uint32_t both_horiz =
     ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT | ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT;
 
+/**
+ * Check whether the state of a layer surface changed in a way which affects the arrangement of the layers,
+ * i.e its own position or size, or the reserved areas on its output.
+ */
+static bool arrangement_changed(const wlr_layer_surface_v1_state& a, const wlr_layer_surface_v1_state& b)
+{
+    return (a.anchor != b.anchor) ||
+           (a.exclusive_zone != b.exclusive_zone) ||
+           (a.margin.top != b.margin.top) ||
+           (a.margin.bottom != b.margin.bottom) ||
+           (a.margin.left != b.margin.left) ||
+           (a.margin.right != b.margin.right) ||
+           (a.desired_width != b.desired_width) ||
+           (a.desired_height != b.desired_height);
+}
+
 class wayfire_layer_shell_view : public wf::view_interface_t
 {
     wf::wl_listener_wrapper on_map;
@@ -50,6 +67,19 @@ class wayfire_layer_shell_view : public wf::view_interface_t
     /** The output geometry of the view */
     wf::geometry_t geometry{100, 100, 0, 0};
 
+    /**
+     * The box the view was last configured with while mapped, together with the state the client had
+     * requested at that time. Rearranging the layers does not send configures to views whose box and
+     * requested state did not change.
+     */
+    struct last_configure_t
+    {
+        wf::geometry_t box;
+        wlr_layer_surface_v1_state requested;
+    };
+
+    std::optional<last_configure_t> last_configure;
+
     std::string app_id;
     friend class wf::tracking_allocator_t<view_interface_t>;
     wayfire_layer_shell_view(wlr_layer_surface_v1 *lsurf);
@@ -527,6 +557,7 @@ void wayfire_layer_shell_view::unmap()
     priv->unset_mapped_surface_contents();
     priv->set_mapped(nullptr);
     on_surface_commit.disconnect();
+    last_configure.reset();
     emit_view_unmap();
     priv->set_enabled(false);
     wf_layer_shell_manager::get_instance().handle_unmap(this);
@@ -557,9 +588,10 @@ void wayfire_layer_shell_view::commit()
             wf::scene::readd_front(get_output()->node_for_layer(get_layer()), get_root_node());
             /* Will also trigger reflowing */
             wf_layer_shell_manager::get_instance().handle_move_layer(this);
-        } else
+        } else if (arrangement_changed(prev_state, *state))
         {
-            /* Reflow reserved areas and positions */
+            /* Reflow reserved areas and positions. Commits which do not change the arrangement (for
+             * example, a panel redrawing its clock) do not need this. */
             wf_layer_shell_manager::get_instance().arrange_layers(get_output());
         }
 
@@ -633,6 +665,19 @@ void wayfire_layer_shell_view::configure(wf::geometry_t box)
         return;
     }
 
+    if (is_mapped())
+    {
+        // A client which changed its requested size, anchor, etc. waits for a configure, even if its box
+        // stays the same.
+        if (last_configure && (last_configure->box == box) &&
+            !arrangement_changed(last_configure->requested, *state))
+        {
+            return;
+        }
+
+        last_configure = last_configure_t{box, *state};
+    }
+
     // TODO: transactions here could make sense, since we want to change x,y,w,h together, but have to wait
     // for the client to resize.
     move(box.x, box.y);
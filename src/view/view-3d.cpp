@@ -477,12 +477,58 @@ uint32_t transformer_base_node_t::optimize_update(uint32_t flags)
     return optimize_nested_render_instances(shared_from_this(), flags);
 }
 
+float transformer_base_node_t::get_mip_scale(float display_scale)
+{
+    if (display_scale >= 1.0)
+    {
+        return 1.0;
+    }
+
+    // Cap the level, so that we do not end up with tiny buffers for views which are (almost) hidden.
+    const int max_level = 5;
+    int level = std::clamp((int)std::floor(std::log2(1.0 / std::max(display_scale, 1e-3f))), 0, max_level);
+    return std::ldexp(1.0f, -level);
+}
+
+void transformer_base_node_t::set_thumbnail_mode(std::optional<thumbnail_mode_t> mode)
+{
+    if (!mode.has_value() && thumbnail_mode.has_value())
+    {
+        // Make sure any damage which was held back is rendered at full resolution.
+        deferred_update.disconnect();
+        wf::scene::damage_node(shared_from_this(), get_bounding_box());
+    }
+
+    this->thumbnail_mode = mode;
+}
+
 wf::texture_t transformer_base_node_t::get_updated_contents(const wf::geometry_t& bbox, float scale,
     std::vector<scene::render_instance_uptr>& children)
 {
+    if (thumbnail_mode)
+    {
+        scale *= get_mip_scale(thumbnail_mode->display_scale);
+    }
+
     if (inner_content.allocate(wf::dimensions(bbox), scale) != buffer_reallocation_result_t::SAME)
     {
         cached_damage |= bbox;
+    } else if (thumbnail_mode && !cached_damage.empty())
+    {
+        const int64_t since_update = wf::get_current_time() - last_contents_update;
+        if (since_update < thumbnail_mode->refresh_interval)
+        {
+            // The old contents are still valid, just outdated. Show them until the interval passes.
+            if (!deferred_update.is_connected())
+            {
+                deferred_update.set_timeout(thumbnail_mode->refresh_interval - since_update, [=] ()
+                {
+                    wf::scene::damage_node(shared_from_this(), get_bounding_box());
+                });
+            }
+
+            return wf::texture_t{inner_content.get_texture(), {}};
+        }
     }
 
     wf::render_target_t target{inner_content};
@@ -498,6 +544,7 @@ wf::texture_t transformer_base_node_t::get_updated_contents(const wf::geometry_t
     wf::render_pass_t::run(params);
 
     cached_damage.clear();
+    last_contents_update = wf::get_current_time();
     return wf::texture_t{inner_content.get_texture(), {}};
 }
 
@@ -107,6 +107,7 @@ void wf::view_interface_t::emit_view_pre_unmap()
 
 void wf::view_implementation::emit_title_changed_signal(wayfire_view view)
 {
+    view->priv->property_generation++;
     view_title_changed_signal data;
     data.view = view;
     view->emit(&data);
@@ -115,6 +116,7 @@ void wf::view_implementation::emit_title_changed_signal(wayfire_view view)
 
 void wf::view_implementation::emit_app_id_changed_signal(wayfire_view view)
 {
+    view->priv->property_generation++;
     view_app_id_changed_signal data;
     data.view = view;
     view->emit(&data);
@@ -33,6 +33,7 @@ class view_interface_t::view_priv_impl
     uint32_t allowed_actions = VIEW_ALLOW_ALL;
 
     uint32_t edges = 0;
+    uint64_t property_generation = 0;
     wlr_box minimize_hint = {0, 0, 0, 0};
 
     scene::floating_inner_ptr root_node;
@@ -19,6 +19,11 @@ void wf::view_interface_t::set_role(view_role_t new_role)
     role = new_role;
 }
 
+uint64_t wf::view_interface_t::get_property_generation() const
+{
+    return priv->property_generation;
+}
+
 std::string wf::view_interface_t::to_string() const
 {
     return "view-" + wf::object_base_t::to_string();
@@ -60,6 +60,7 @@ void wf::xdg_toplevel_t::commit()
     {
         // Send frame done to let the client know it update its state as fast as possible.
         this->target_configure = *configure_serial;
+        configure_sent();
         main_surface->send_frame_done(true);
     } else
     {
@@ -138,6 +139,7 @@ void wf::xdg_toplevel_t::apply()
         }
     }
 
+    configure_done();
     this->_current = committed();
     const bool is_pending = wf::get_core().tx_manager->is_object_pending(shared_from_this());
     if (!is_pending)
@@ -182,6 +184,7 @@ void wf::xdg_toplevel_t::handle_surface_commit()
         const wf::dimensions_t real_size =
             expand_dimensions_by_margins(get_current_wlr_toplevel_size(), _committed.margins);
         wf::adjust_geometry_for_gravity(_committed, real_size);
+        configure_acked();
         emit_ready();
         return;
     }
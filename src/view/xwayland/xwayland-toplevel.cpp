@@ -130,6 +130,7 @@ void wf::xw::xwayland_toplevel_t::commit()
     if (wait_for_client && main_surface)
     {
         // Send frame done to let the client know it can resize
+        configure_sent();
         main_surface->send_frame_done(true);
     } else
     {
@@ -189,6 +190,7 @@ void wf::xw::xwayland_toplevel_t::apply()
             expand_dimensions_by_margins(this->get_current_xw_size(), _committed.margins));
     }
 
+    configure_done();
     this->_current = committed();
     const bool is_pending = wf::get_core().tx_manager->is_object_pending(shared_from_this());
     if (!is_pending)
@@ -227,6 +229,7 @@ void wf::xw::xwayland_toplevel_t::handle_surface_commit()
         }
 
         adjust_geometry_for_gravity(_committed, this->get_current_xw_size());
+        configure_acked();
         emit_ready();
         return;
     }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <doctest/doctest.h>
+#include <chrono>
+#include <ratio>
+
+/**
+ * Declare a benchmark. Benchmarks are test cases which are skipped in the default test run, and run only with
+ * `meson test --benchmark`, which passes --no-skip and selects them by their name.
+ */
+#define WF_BENCHMARK(name) TEST_CASE("Benchmark: " name * doctest::skip())
+
+namespace wf
+{
+namespace bench
+{
+/**
+ * Run @func(i) for i in [0, @iterations), and return the average time of one iteration in the given unit
+ * (microseconds by default).
+ */
+template<class Unit = std::micro, class Func>
+double measure(int iterations, Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        func(i);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, Unit>(elapsed).count() / iterations;
+}
+}
+}
@@ -0,0 +1,96 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../plugins/cube/cube-visibility.hpp"
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cmath>
+
+#define Z_OFFSET_NEAR 0.89567f
+
+/* The camera setup used by the cube plugin, see wayfire_cube::update_view_matrix() */
+struct cube_camera_t
+{
+    int num_faces;
+    float side_angle;
+    float z_offset;
+    glm::mat4 projection = glm::perspective(45.0f, 1.f, 0.1f, 100.f);
+
+    cube_camera_t(int num_faces) : num_faces(num_faces)
+    {
+        side_angle = 2 * M_PI / float(num_faces);
+        z_offset   = (num_faces == 1) ? 0.0f : 0.5 / std::tan(side_angle / 2);
+    }
+
+    glm::mat4 view(float offset_y, float zoom = 1.0) const
+    {
+        float offset_z = z_offset + Z_OFFSET_NEAR;
+        auto zoom_translate = glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, -offset_z));
+        auto rotation = glm::rotate(glm::mat4(1.0), offset_y, glm::vec3(1., 0., 0.));
+        auto view = glm::lookAt(glm::vec3(0., 0., 0.), glm::vec3(0., 0., -offset_z),
+            glm::vec3(0., 1., 0.));
+        auto scale = glm::scale(glm::mat4(1.0), glm::vec3(1. / zoom, 1. / zoom, 1. / zoom));
+
+        return zoom_translate * rotation * view * scale;
+    }
+
+    std::vector<bool> visible(float rotation, float offset_y, float zoom = 1.0) const
+    {
+        return wf::cube::compute_visible_faces(num_faces, side_angle, rotation, z_offset,
+            view(offset_y, zoom), projection);
+    }
+};
+
+TEST_CASE("Only the face in front is visible when looking straight at the cube")
+{
+    cube_camera_t camera{4};
+    REQUIRE(camera.visible(0.0, 0.0) == std::vector<bool>{true, false, false, false});
+}
+
+TEST_CASE("Faces behind the front faces are visible through the open top of the cube")
+{
+    cube_camera_t camera{4};
+    auto visible = camera.visible(0.0, 0.8);
+    REQUIRE(visible[0]);
+    REQUIRE(visible[2]);
+}
+
+TEST_CASE("At least one face is visible for any rotation")
+{
+    for (int num_faces : {2, 3, 4, 6, 9})
+    {
+        cube_camera_t camera{num_faces};
+        for (int step = 0; step < 360; step++)
+        {
+            float rotation = step * 2 * M_PI / 360;
+            for (float offset_y : {-0.8f, 0.0f, 0.8f})
+            {
+                auto visible = camera.visible(rotation, offset_y);
+                REQUIRE(visible.size() == (size_t)num_faces);
+                REQUIRE(std::count(visible.begin(), visible.end(), true) >= 1);
+            }
+        }
+    }
+}
+
+WF_BENCHMARK("culling cube faces while rotating")
+{
+    const int nr_frames = 100'000;
+    for (int num_faces : {4, 9})
+    {
+        cube_camera_t camera{num_faces};
+        size_t culled = 0;
+        double per_frame = wf::bench::measure(nr_frames, [&] (int frame)
+        {
+            // One full turn every 1000 frames, with the camera slowly tilting up and down
+            float rotation = frame * 2 * M_PI / 1000;
+            float offset_y = 0.8 * std::sin(frame * 2 * M_PI / 10'000);
+            auto visible   = camera.visible(rotation, offset_y);
+            culled += std::count(visible.begin(), visible.end(), false);
+        });
+
+        REQUIRE(culled > 0);
+        MESSAGE(num_faces << " faces, " << nr_frames << " frames: " << per_frame << "us per frame, " <<
+            double(culled) / nr_frames << " faces culled per frame");
+    }
+}
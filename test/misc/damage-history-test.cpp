@@ -0,0 +1,56 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/render.hpp>
+
+static const wf::geometry_t extents = {0, 0, 100, 100};
+
+static bool same_region(const wf::region_t& a, const wf::region_t& b)
+{
+    return (a ^ b).empty() && (b ^ a).empty();
+}
+
+TEST_CASE("Unknown buffers are repainted fully")
+{
+    wf::damage_history_t history;
+    int buffer;
+
+    history.add(wf::geometry_t{0, 0, 10, 10});
+    history.rotate();
+    REQUIRE(same_region(history.get_buffer_damage(&buffer, extents), extents));
+}
+
+TEST_CASE("Buffers accumulate the damage of the frames since they were painted")
+{
+    wf::damage_history_t history{3};
+    int a, b;
+
+    history.rotate();
+    history.mark_painted(&a);
+    history.add(wf::geometry_t{0, 0, 10, 10});
+
+    history.rotate();
+    history.mark_painted(&b);
+    history.add(wf::geometry_t{20, 20, 10, 10});
+
+    history.rotate();
+    REQUIRE(same_region(history.get_buffer_damage(&b, extents), wf::geometry_t{20, 20, 10, 10}));
+
+    wf::region_t expected_a = wf::geometry_t{0, 0, 10, 10};
+    expected_a |= wf::geometry_t{20, 20, 10, 10};
+    REQUIRE(same_region(history.get_buffer_damage(&a, extents), expected_a));
+
+    // Damage outside of the extents is ignored
+    history.add(wf::geometry_t{90, 90, 50, 50});
+    history.rotate();
+    history.mark_painted(&b);
+    REQUIRE(same_region(history.get_buffer_damage(&b, extents), {}));
+
+    // a is now too old
+    history.rotate();
+    history.rotate();
+    REQUIRE(same_region(history.get_buffer_damage(&a, extents), extents));
+
+    history.forget(&b);
+    REQUIRE(same_region(history.get_buffer_damage(&b, extents), extents));
+}
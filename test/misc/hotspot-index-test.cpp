@@ -0,0 +1,137 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/core/seat/hotspot-manager.hpp"
+#include <algorithm>
+#include "benchmark.hpp"
+#include <random>
+
+static const wf::geometry_t output = {1920, 0, 1920, 1080};
+
+static std::vector<size_t> query(const wf::hotspot_index_t& index, wf::pointf_t point)
+{
+    std::vector<size_t> result;
+    index.query(point, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST_CASE("Hotspots are found only near their edges")
+{
+    wf::hotspot_index_t index;
+    index.reset(output);
+
+    // Top edge, centered
+    wf::geometry_t top[2] = {{2780, 0, 200, 10}, {2780, 0, 200, 10}};
+    index.add(OUTPUT_EDGE_TOP, top, 2, 0);
+
+    // Bottom-left corner
+    wf::geometry_t corner[2] = {{1920, 980, 10, 100}, {1920, 1070, 100, 10}};
+    index.add(OUTPUT_EDGE_BOTTOM | OUTPUT_EDGE_LEFT, corner, 2, 1);
+
+    REQUIRE(query(index, {2880, 5}) == std::vector<size_t>{0});
+    REQUIRE(query(index, {2880, 15}).empty());
+    REQUIRE(query(index, {2000, 5}).empty());
+    REQUIRE(query(index, {2880, 540}).empty());
+
+    REQUIRE(query(index, {1925, 1000}) == std::vector<size_t>{1});
+    REQUIRE(query(index, {2000, 1075}) == std::vector<size_t>{1});
+    // In both rectangles, but reported once
+    REQUIRE(query(index, {1925, 1075}) == std::vector<size_t>{1});
+    REQUIRE(query(index, {1935, 1000}).empty());
+}
+
+WF_BENCHMARK("many hotspots and high-rate motion")
+{
+    static const uint32_t all_edges[] = {
+        OUTPUT_EDGE_LEFT, OUTPUT_EDGE_RIGHT, OUTPUT_EDGE_TOP, OUTPUT_EDGE_BOTTOM,
+        OUTPUT_EDGE_LEFT | OUTPUT_EDGE_TOP, OUTPUT_EDGE_RIGHT | OUTPUT_EDGE_TOP,
+        OUTPUT_EDGE_LEFT | OUTPUT_EDGE_BOTTOM, OUTPUT_EDGE_RIGHT | OUTPUT_EDGE_BOTTOM,
+    };
+
+    std::mt19937 gen(42);
+    const int nr_hotspots = 256;
+
+    wf::hotspot_index_t index;
+    index.reset(output);
+    std::vector<std::pair<wf::geometry_t, size_t>> linear;
+    for (int i = 0; i < nr_hotspots; i++)
+    {
+        // Hotspots are built like hotspot_instance_t does, but at random positions along the edge
+        uint32_t edges = all_edges[gen() % 8];
+        int along = 50 + gen() % 200;
+        int away  = 1 + gen() % 20;
+        int pos_x = output.x + gen() % (output.width - along);
+        int pos_y = output.y + gen() % (output.height - along);
+
+        const auto& pin = [&] (int width, int height)
+        {
+            int x = (edges & OUTPUT_EDGE_LEFT) ? output.x :
+                ((edges & OUTPUT_EDGE_RIGHT) ? output.x + output.width - width : pos_x);
+            int y = (edges & OUTPUT_EDGE_TOP) ? output.y :
+                ((edges & OUTPUT_EDGE_BOTTOM) ? output.y + output.height - height : pos_y);
+            return wf::geometry_t{x, y, width, height};
+        };
+
+        wf::geometry_t rects[2];
+        if (__builtin_popcount(edges) == 2)
+        {
+            rects[0] = pin(away, along);
+            rects[1] = pin(along, away);
+        } else if (edges & (OUTPUT_EDGE_LEFT | OUTPUT_EDGE_RIGHT))
+        {
+            rects[0] = rects[1] = pin(away, along);
+        } else
+        {
+            rects[0] = rects[1] = pin(along, away);
+        }
+
+        index.add(edges, rects, 2, i);
+        linear.push_back({rects[0], i});
+        linear.push_back({rects[1], i});
+    }
+
+    // Motion events all over the output, with a part of them close to the edges
+    const int nr_events = 1'000'000;
+    std::vector<wf::pointf_t> events;
+    for (int i = 0; i < nr_events; i++)
+    {
+        double x = output.x + (gen() % (output.width * 100)) / 100.0;
+        double y = output.y + (gen() % (output.height * 100)) / 100.0;
+        if (i % 10 == 0)
+        {
+            x = (i % 20 == 0) ? output.x + (gen() % 2000) / 100.0 : x;
+            y = (i % 20 == 10) ? output.y + output.height - (gen() % 2000) / 100.0 - 0.01 : y;
+        }
+
+        events.push_back({x, y});
+    }
+
+    std::vector<size_t> result;
+    size_t indexed_matches = 0;
+    double indexed = wf::bench::measure<std::nano>(nr_events, [&] (int i)
+    {
+        result.clear();
+        index.query(events[i], result);
+        indexed_matches += result.size();
+    });
+
+    size_t linear_matches = 0;
+    double scanned = wf::bench::measure<std::nano>(nr_events, [&] (int i)
+    {
+        result.clear();
+        for (const auto& [rect, id] : linear)
+        {
+            if ((rect & events[i]) && (std::find(result.begin(), result.end(), id) == result.end()))
+            {
+                result.push_back(id);
+            }
+        }
+
+        linear_matches += result.size();
+    });
+
+    REQUIRE(indexed_matches == linear_matches);
+    MESSAGE(nr_hotspots << " hotspots, " << nr_events << " events: indexed " << indexed <<
+        "ns per event, linear scan " << scanned << "ns per event");
+}
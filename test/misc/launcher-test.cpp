@@ -0,0 +1,101 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/core/launcher.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Dispatch the event loop until all started processes are reaped, or the timeout expires */
+static void wait_for_reaping(wl_event_loop *loop, wf::process_launcher_t& launcher)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (launcher.count_running() && (std::chrono::steady_clock::now() < deadline))
+    {
+        wl_event_loop_dispatch(loop, 100);
+    }
+}
+
+static std::string read_file(const std::string& path)
+{
+    std::ifstream file{path};
+    std::string contents;
+    std::getline(file, contents);
+    return contents;
+}
+
+TEST_CASE("A batch of commands is started and reaped from the event loop")
+{
+    char dir_template[] = "/tmp/wf-launcher-test-XXXXXX";
+    REQUIRE(mkdtemp(dir_template) != nullptr);
+    const std::string dir = dir_template;
+
+    auto loop = wl_event_loop_create();
+    {
+        wf::process_launcher_t launcher{loop};
+
+        wf::launch_params_t params;
+        params.env.push_back({"WF_LAUNCHER_TEST", "batch"});
+        auto pids = launcher.spawn({
+            "echo \"$WF_LAUNCHER_TEST\" > " + dir + "/first",
+            "echo $$ > " + dir + "/second",
+            "exit 3",
+        }, params);
+
+        REQUIRE(pids.size() == 3);
+        for (auto pid : pids)
+        {
+            REQUIRE(pid > 0);
+        }
+
+        wait_for_reaping(loop, launcher);
+        REQUIRE(launcher.count_running() == 0);
+
+        // The processes are gone, not zombies waiting for someone to reap them
+        for (auto pid : pids)
+        {
+            REQUIRE(waitpid(pid, nullptr, WNOHANG) == -1);
+        }
+
+        REQUIRE(read_file(dir + "/first") == "batch");
+        REQUIRE(read_file(dir + "/second") == std::to_string(pids[1]));
+    }
+
+    wl_event_loop_destroy(loop);
+    unlink((dir + "/first").c_str());
+    unlink((dir + "/second").c_str());
+    rmdir(dir.c_str());
+}
+
+TEST_CASE("The environment of the compositor is kept unless overridden")
+{
+    char dir_template[] = "/tmp/wf-launcher-test-XXXXXX";
+    REQUIRE(mkdtemp(dir_template) != nullptr);
+    const std::string dir = dir_template;
+    setenv("WF_LAUNCHER_KEPT", "kept", 1);
+    setenv("WF_LAUNCHER_OVERRIDDEN", "old", 1);
+
+    auto loop = wl_event_loop_create();
+    {
+        wf::process_launcher_t launcher{loop};
+
+        wf::launch_params_t params;
+        params.env.push_back({"WF_LAUNCHER_OVERRIDDEN", "new"});
+        auto pids = launcher.spawn({"echo \"$WF_LAUNCHER_KEPT $WF_LAUNCHER_OVERRIDDEN\" > " + dir + "/env"},
+            params);
+        REQUIRE(pids.size() == 1);
+        REQUIRE(pids[0] > 0);
+
+        wait_for_reaping(loop, launcher);
+        REQUIRE(launcher.count_running() == 0);
+        REQUIRE(read_file(dir + "/env") == "kept new");
+    }
+
+    wl_event_loop_destroy(loop);
+    unsetenv("WF_LAUNCHER_KEPT");
+    unsetenv("WF_LAUNCHER_OVERRIDDEN");
+    unlink((dir + "/env").c_str());
+    rmdir(dir.c_str());
+}
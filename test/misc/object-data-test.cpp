@@ -0,0 +1,156 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/object.hpp>
+#include "benchmark.hpp"
+
+class test_object_t : public wf::object_base_t
+{
+  public:
+    ~test_object_t()
+    {
+        _clear_data();
+    }
+};
+
+template<int N>
+struct data_t : public wf::custom_data_t
+{
+    int value = N;
+};
+
+struct tracked_data_t : public wf::custom_data_t
+{
+    int *destroyed;
+    tracked_data_t(int *destroyed) : destroyed(destroyed)
+    {}
+
+    ~tracked_data_t()
+    {
+        ++(*destroyed);
+    }
+};
+
+TEST_CASE("Typed data can be stored, fetched and erased")
+{
+    test_object_t object;
+    REQUIRE(!object.has_data<data_t<1>>());
+    REQUIRE(object.get_data<data_t<1>>() == nullptr);
+
+    object.store_data(std::make_unique<data_t<1>>());
+    REQUIRE(object.has_data<data_t<1>>());
+    REQUIRE(object.get_data<data_t<1>>()->value == 1);
+    REQUIRE(!object.has_data<data_t<2>>());
+
+    object.get_data_safe<data_t<2>>()->value = 5;
+    REQUIRE(object.get_data<data_t<2>>()->value == 5);
+
+    object.erase_data<data_t<1>>();
+    REQUIRE(!object.has_data<data_t<1>>());
+    REQUIRE(object.get_data<data_t<2>>()->value == 5);
+
+    auto released = object.release_data<data_t<2>>();
+    REQUIRE(released->value == 5);
+    REQUIRE(!object.has_data<data_t<2>>());
+}
+
+TEST_CASE("Typed and named data do not collide")
+{
+    test_object_t object;
+    object.store_data(std::make_unique<data_t<1>>(), "named");
+    REQUIRE(object.has_data("named"));
+    REQUIRE(!object.has_data<data_t<1>>());
+
+    object.store_data(std::make_unique<data_t<1>>());
+    object.get_data<data_t<1>>()->value = 2;
+    REQUIRE(object.get_data<data_t<1>>("named")->value == 1);
+
+    object.erase_data("named");
+    REQUIRE(object.has_data<data_t<1>>());
+}
+
+TEST_CASE("Typed data can be accessed by its type name")
+{
+    test_object_t object;
+    const std::string name = typeid(data_t<7>).name();
+
+    object.store_data(std::make_unique<data_t<7>>());
+    REQUIRE(object.has_data(name));
+    REQUIRE(object.get_data<data_t<7>>(name)->value == 7);
+
+    object.store_data(std::make_unique<data_t<7>>(), name);
+    object.get_data<data_t<7>>(name)->value = 3;
+    REQUIRE(object.get_data<data_t<7>>()->value == 3);
+
+    auto released = object.release_data<data_t<7>>(name);
+    REQUIRE(released->value == 3);
+    REQUIRE(!object.has_data<data_t<7>>());
+
+    object.store_data(std::make_unique<data_t<7>>());
+    object.erase_data(name);
+    REQUIRE(!object.has_data<data_t<7>>());
+}
+
+TEST_CASE("Many types of data can be stored")
+{
+    test_object_t object;
+    object.store_data(std::make_unique<data_t<1>>());
+    object.store_data(std::make_unique<data_t<2>>());
+    object.store_data(std::make_unique<data_t<3>>());
+    object.store_data(std::make_unique<data_t<4>>());
+    object.store_data(std::make_unique<data_t<5>>());
+    object.store_data(std::make_unique<data_t<6>>());
+    object.store_data(std::make_unique<data_t<7>>());
+    object.store_data(std::make_unique<data_t<8>>());
+    object.store_data(std::make_unique<data_t<9>>());
+    object.store_data(std::make_unique<data_t<10>>());
+
+    REQUIRE(object.get_data<data_t<1>>()->value == 1);
+    REQUIRE(object.get_data<data_t<8>>()->value == 8);
+    REQUIRE(object.get_data<data_t<10>>()->value == 10);
+
+    // Free an inline entry and reuse it
+    object.erase_data<data_t<3>>();
+    object.store_data(std::make_unique<data_t<11>>());
+    REQUIRE(!object.has_data<data_t<3>>());
+    REQUIRE(object.get_data<data_t<11>>()->value == 11);
+    REQUIRE(object.get_data<data_t<9>>()->value == 9);
+}
+
+TEST_CASE("Typed data is destroyed when replaced and when the object is destroyed")
+{
+    int destroyed = 0;
+    {
+        test_object_t object;
+        object.store_data(std::make_unique<tracked_data_t>(&destroyed));
+        object.store_data(std::make_unique<tracked_data_t>(&destroyed));
+        REQUIRE(destroyed == 1);
+    }
+
+    REQUIRE(destroyed == 2);
+}
+
+WF_BENCHMARK("typed and named lookups")
+{
+    test_object_t object;
+    object.store_data(std::make_unique<data_t<1>>());
+    object.store_data(std::make_unique<data_t<2>>());
+    object.store_data(std::make_unique<data_t<3>>());
+    object.store_data(std::make_unique<data_t<1>>(), "data-1");
+    object.store_data(std::make_unique<data_t<2>>(), "data-2");
+    object.store_data(std::make_unique<data_t<3>>(), "data-3");
+
+    const int iterations = 1'000'000;
+    long sum = 0;
+    double typed = wf::bench::measure<std::nano>(iterations, [&] (int)
+    {
+        sum += object.get_data<data_t<3>>()->value;
+    });
+    double named = wf::bench::measure<std::nano>(iterations, [&] (int)
+    {
+        sum += object.get_data<data_t<3>>("data-3")->value;
+    });
+
+    REQUIRE(sum == 6L * iterations);
+    MESSAGE("typed lookup: " << typed << "ns, named lookup: " << named << "ns");
+}
@@ -0,0 +1,126 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/render.hpp>
+#include <wayfire/util.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+TEST_CASE("Fences without a sync point are signaled")
+{
+    wf::render_fence_t fence;
+    REQUIRE_FALSE(fence.has_sync_point());
+    REQUIRE(fence.is_signaled());
+    REQUIRE(fence.export_sync_file() == -1);
+
+    wf::render_fence_t copy = fence;
+    REQUIRE_FALSE(copy.has_sync_point());
+    REQUIRE(copy.is_signaled());
+}
+
+TEST_CASE("Auxilliary buffers start with a signaled fence")
+{
+    wf::auxilliary_buffer_t buffer;
+    REQUIRE(buffer.get_ready_fence().is_signaled());
+
+    buffer.set_ready_fence(wf::render_fence_t{});
+    wf::auxilliary_buffer_t moved = std::move(buffer);
+    REQUIRE(moved.get_ready_fence().is_signaled());
+}
+
+/* The kernel's software sync timeline (CONFIG_SW_SYNC), which creates fences that are signaled on demand */
+struct sw_sync_create_fence_data
+{
+    uint32_t value;
+    char name[32];
+    int32_t fence;
+};
+
+#define SW_SYNC_IOC_MAGIC 'W'
+#define SW_SYNC_IOC_CREATE_FENCE _IOWR(SW_SYNC_IOC_MAGIC, 0, struct sw_sync_create_fence_data)
+#define SW_SYNC_IOC_INC _IOW(SW_SYNC_IOC_MAGIC, 1, uint32_t)
+
+static int open_render_node()
+{
+    for (int i = 128; i < 136; i++)
+    {
+        std::string path = "/dev/dri/renderD" + std::to_string(i);
+        int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            return fd;
+        }
+    }
+
+    return -1;
+}
+
+TEST_CASE("Waiting for a fence which is signaled later")
+{
+    int drm_fd = open_render_node();
+    int sw_sync_fd = open("/sys/kernel/debug/sync/sw_sync", O_RDWR | O_CLOEXEC);
+    auto timeline  = (drm_fd >= 0) ? wlr_drm_syncobj_timeline_create(drm_fd) : nullptr;
+    if (!timeline || (sw_sync_fd < 0))
+    {
+        MESSAGE("Skipping: needs a DRM render node with syncobj support and sw_sync");
+        if (timeline)
+        {
+            wlr_drm_syncobj_timeline_unref(timeline);
+        }
+
+        for (int fd : {drm_fd, sw_sync_fd})
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+
+        return;
+    }
+
+    // Point 1 of the timeline is backed by a fence which is signaled only when the sw_sync timeline advances.
+    sw_sync_create_fence_data data = {};
+    data.value = 1;
+    std::strcpy(data.name, "render-fence-test");
+    REQUIRE(ioctl(sw_sync_fd, SW_SYNC_IOC_CREATE_FENCE, &data) == 0);
+    REQUIRE(wlr_drm_syncobj_timeline_import_sync_file(timeline, 1, data.fence));
+    close(data.fence);
+
+    wf::wl_idle_call::loop = wl_event_loop_create();
+    {
+        wf::render_fence_t fence{timeline, 1};
+        REQUIRE(fence.has_sync_point());
+        REQUIRE_FALSE(fence.is_signaled());
+
+        int nr_called = 0;
+        std::unique_ptr<wf::render_fence_waiter_t> waiter;
+        waiter = fence.wait_async([&] ()
+        {
+            ++nr_called;
+            // Destroying the waiter from its own callback is allowed.
+            waiter.reset();
+        });
+
+        wl_event_loop_dispatch(wf::wl_idle_call::loop, 0);
+        REQUIRE(nr_called == 0);
+
+        uint32_t inc = 1;
+        REQUIRE(ioctl(sw_sync_fd, SW_SYNC_IOC_INC, &inc) == 0);
+        REQUIRE(fence.is_signaled());
+
+        wl_event_loop_dispatch(wf::wl_idle_call::loop, 1000);
+        REQUIRE(nr_called == 1);
+        REQUIRE(waiter == nullptr);
+    }
+
+    wl_event_loop_destroy(wf::wl_idle_call::loop);
+    wf::wl_idle_call::loop = NULL;
+    wlr_drm_syncobj_timeline_unref(timeline);
+    close(sw_sync_fd);
+    close(drm_fd);
+}
@@ -0,0 +1,244 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../plugins/tile/tree.hpp"
+#include <wayfire/toplevel-view.hpp>
+#include "benchmark.hpp"
+#include <random>
+
+using namespace wf::tile;
+
+/* A leaf which is not backed by a view, so that trees can be laid out without a compositor */
+struct leaf_t : public tree_node_t
+{
+    void set_gaps(const gap_size_t& gaps) override
+    {
+        this->gaps = gaps;
+    }
+};
+
+static void collect_leaves(nonstd::observer_ptr<tree_node_t> node,
+    std::vector<nonstd::observer_ptr<tree_node_t>>& out)
+{
+    if (node->children.empty())
+    {
+        out.push_back(node);
+    }
+
+    for (auto& child : node->children)
+    {
+        collect_leaves({child}, out);
+    }
+}
+
+static size_t count_nodes(nonstd::observer_ptr<tree_node_t> node)
+{
+    size_t count = 1;
+    for (auto& child : node->children)
+    {
+        count += count_nodes({child});
+    }
+
+    return count;
+}
+
+/* Build a random tree with the given number of nodes, by splitting random leaves */
+static std::unique_ptr<split_node_t> build_tree(size_t nr_nodes, wf::geometry_t geometry)
+{
+    std::mt19937 gen(42);
+    layout_batch_t batch{true};
+
+    auto root = std::make_unique<split_node_t>(SPLIT_VERTICAL);
+    root->set_geometry(geometry, batch);
+    root->add_child(std::make_unique<leaf_t>(), batch);
+    size_t count = 2;
+    while (count < nr_nodes)
+    {
+        std::vector<nonstd::observer_ptr<tree_node_t>> leaves;
+        collect_leaves(root, leaves);
+
+        // Only split leaves which are big enough to stay non-empty after resizing the tree
+        auto leaf = leaves[gen() % leaves.size()];
+        if ((leaf->geometry.width < 20) || (leaf->geometry.height < 20))
+        {
+            continue;
+        }
+
+        auto parent = leaf->parent;
+
+        if ((count + 2 <= nr_nodes) && (gen() % 3 == 0))
+        {
+            // Replace the leaf with a split in the other direction, containing the leaf and a new one
+            auto direction = (parent->get_split_direction() == SPLIT_VERTICAL) ?
+                SPLIT_HORIZONTAL : SPLIT_VERTICAL;
+            auto split = std::make_unique<split_node_t>(direction);
+            split->set_geometry(leaf->geometry, batch);
+
+            int idx = 0;
+            while (parent->children[idx].get() != leaf.get())
+            {
+                ++idx;
+            }
+
+            split->add_child(parent->remove_child(leaf, batch), batch);
+            split->add_child(std::make_unique<leaf_t>(), batch);
+            parent->add_child(std::move(split), batch, idx);
+            count += 2;
+        } else
+        {
+            parent->add_child(std::make_unique<leaf_t>(), batch, gen() % (parent->children.size() + 1));
+            count += 1;
+        }
+    }
+
+    return root;
+}
+
+TEST_CASE("Leaves cover the whole tree geometry")
+{
+    const wf::geometry_t geometry = {0, 0, 1920, 1080};
+    auto root = build_tree(200, geometry);
+    REQUIRE(count_nodes(root) == 200);
+
+    for (auto target : {wf::geometry_t{0, 0, 3840, 2160}, wf::geometry_t{100, 50, 1366, 768}, geometry})
+    {
+        layout_batch_t batch{true};
+        root->set_geometry(target, batch);
+
+        std::vector<nonstd::observer_ptr<tree_node_t>> leaves;
+        collect_leaves(root, leaves);
+
+        int64_t area = 0;
+        for (auto& leaf : leaves)
+        {
+            auto g = leaf->geometry;
+            REQUIRE(g.width >= 0);
+            REQUIRE(g.height >= 0);
+            REQUIRE(g.x >= target.x);
+            REQUIRE(g.y >= target.y);
+            REQUIRE(g.x + g.width <= target.x + target.width);
+            REQUIRE(g.y + g.height <= target.y + target.height);
+            area += (int64_t)leaf->geometry.width * leaf->geometry.height;
+        }
+
+        REQUIRE(area == (int64_t)target.width * target.height);
+    }
+}
+
+/* Views are only compared and sorted by the batches, so fake pointers are enough */
+static wayfire_toplevel_view fake_view(uintptr_t id)
+{
+    return wayfire_toplevel_view{reinterpret_cast<wf::toplevel_view_interface_t*>(id * 64)};
+}
+
+/* Replaces the way batches apply views while alive, and records what they apply */
+struct batch_recorder_t
+{
+    std::vector<std::vector<wayfire_toplevel_view>> commits;
+
+    batch_recorder_t()
+    {
+        layout_batch_t::apply_views = [=] (const std::vector<wayfire_toplevel_view>& views)
+        {
+            commits.push_back(views);
+        };
+    }
+
+    ~batch_recorder_t()
+    {
+        layout_batch_t::apply_views = layout_batch_t::apply_in_transaction;
+    }
+};
+
+TEST_CASE("Nested batches are committed once, by the outermost batch")
+{
+    batch_recorder_t recorder;
+    auto a = fake_view(1), b = fake_view(2), c = fake_view(3);
+    {
+        layout_batch_t outer;
+        {
+            layout_batch_t inner;
+            inner.add(b);
+            inner.add(a);
+            {
+                layout_batch_t innermost;
+                innermost.add(c);
+                innermost.add(a);
+            }
+
+            REQUIRE(recorder.commits.empty());
+        }
+
+        REQUIRE(recorder.commits.empty());
+        outer.add(b);
+    }
+
+    // Each view is applied once, no matter how often its node was resized
+    REQUIRE(recorder.commits.size() == 1);
+    REQUIRE(recorder.commits[0] == std::vector<wayfire_toplevel_view>{a, b, c});
+
+    // After the outermost batch is gone, a new batch is the outermost one again
+    {
+        layout_batch_t batch;
+        batch.add(c);
+    }
+
+    REQUIRE(recorder.commits.size() == 2);
+    REQUIRE(recorder.commits[1] == std::vector<wayfire_toplevel_view>{c});
+}
+
+TEST_CASE("Empty and dry-run batches do not apply anything")
+{
+    batch_recorder_t recorder;
+    {
+        layout_batch_t batch;
+    }
+
+    {
+        layout_batch_t dry_run{true};
+        dry_run.add(fake_view(1));
+
+        // A dry run does not capture real batches created while it is alive
+        layout_batch_t real;
+        real.add(fake_view(2));
+    }
+
+    REQUIRE(recorder.commits.size() == 1);
+    REQUIRE(recorder.commits[0] == std::vector<wayfire_toplevel_view>{fake_view(2)});
+}
+
+TEST_CASE("Views which already have the tiled geometry pending are skipped")
+{
+    const wf::geometry_t target = {10, 20, 300, 400};
+    wf::toplevel_state_t current, pending;
+    pending.geometry    = target;
+    pending.tiled_edges = wf::TILED_EDGES_ALL;
+    REQUIRE(view_node_t::is_tiled_state_pending(pending, current, target));
+
+    REQUIRE_FALSE(view_node_t::is_tiled_state_pending(pending, current, {10, 20, 300, 401}));
+
+    pending.tiled_edges = 0;
+    REQUIRE_FALSE(view_node_t::is_tiled_state_pending(pending, current, target));
+
+    // Leaving fullscreen needs a new transaction, even if the geometry stays the same
+    pending.tiled_edges = wf::TILED_EDGES_ALL;
+    current.fullscreen  = true;
+    REQUIRE_FALSE(view_node_t::is_tiled_state_pending(pending, current, target));
+}
+
+WF_BENCHMARK("reflow of a tree with 200 nodes")
+{
+    const wf::geometry_t geometry = {0, 0, 1920, 1080};
+    auto root = build_tree(200, geometry);
+
+    const int nr_reflows = 10'000;
+    double per_reflow = wf::bench::measure(nr_reflows, [&] (int i)
+    {
+        layout_batch_t batch{true};
+        auto target = geometry;
+        target.width -= (i % 2) * 100;
+        root->set_geometry(target, batch);
+    });
+
+    MESSAGE(count_nodes(root) << " nodes, " << nr_reflows << " reflows: " << per_reflow << "us per reflow");
+}